@@ -0,0 +1,34 @@
+// Offline shell for the control app. Pages and icons come from the cache and are
+// refreshed in the background; the API and WebSocket always go to the device.
+const CACHE_NAME = 'space-tornado-v1';
+const SHELL = ['./', 'manifest.json', 'icon-192.svg', 'icon-512.svg'];
+
+self.addEventListener('install', event => {
+    event.waitUntil(caches.open(CACHE_NAME).then(cache => cache.addAll(SHELL)));
+    self.skipWaiting();
+});
+
+self.addEventListener('activate', event => {
+    event.waitUntil(caches.keys().then(keys =>
+        Promise.all(keys.filter(key => key !== CACHE_NAME).map(key => caches.delete(key)))));
+    self.clients.claim();
+});
+
+self.addEventListener('fetch', event => {
+    const url = new URL(event.request.url);
+    if (event.request.method !== 'GET' || url.origin !== self.location.origin || url.pathname.startsWith('/api/')) {
+        return;
+    }
+    event.respondWith(caches.open(CACHE_NAME).then(async cache => {
+        const cached = await cache.match(event.request, { ignoreSearch: true });
+        const refresh = fetch(event.request).then(response => {
+            if (response.ok) cache.put(event.request, response.clone());
+            return response;
+        });
+        if (cached) {
+            refresh.catch(() => {});
+            return cached;
+        }
+        return refresh;
+    }));
+});
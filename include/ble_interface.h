@@ -2,11 +2,74 @@
 #define BLE_INTERFACE_H
 
 #include "config.h"
+#include "telemetry.h"
+
+#include <stdint.h>
+
+// Binary command writes on the command characteristic, little-endian:
+//   u8 BLE_COMMAND_VERSION, u16 seq, then opcodes with their arguments.
+// One write may pack several opcodes (e.g. speed + direction + fire). Writes
+// starting with any other byte are parsed as text commands (command_parser.h).
+// The whole write is validated first; a malformed one applies nothing.
+// Speed, direction and fire are applied together after the other opcodes.
+#define BLE_COMMAND_VERSION 0x01    // Never a valid first byte of a text command
+
+enum BleOpcode : uint8_t {
+    BLE_OP_SET_SPEED = 0x01,            // u16 target speed (0.1 %)
+    BLE_OP_DIRECTION = 0x02,            // u8 1 = forward, 0 = reverse
+    BLE_OP_FIRE = 0x03,                 // u8 1 = fire, 0 = stop
+    BLE_OP_ADJUST_SPEED = 0x04,         // i16 delta (0.1 %)
+    BLE_OP_EMERGENCY_STOP = 0x05,
+    BLE_OP_CLEAR_EMERGENCY_STOP = 0x06,
+    BLE_OP_STATUS = 0x07,               // Notify status now
+};
+
+// Outcome of the newest binary write, reported in status notifications
+enum BleAckStatus : uint8_t {
+    BLE_ACK_NONE = 0,           // No binary write yet on this connection
+    BLE_ACK_APPLIED = 1,        // Applied by the control task
+    BLE_ACK_STALE = 2,          // seq not newer than the last accepted one
+    BLE_ACK_REJECTED = 3,       // Malformed or unknown opcode; nothing applied
+    BLE_ACK_BUSY = 4,           // Command queue full; some opcodes were dropped
+};
+
+// Status notification: the shared TelemetryFrame plus this central's ack
+// (17 bytes). Frame decoders that ignore trailing bytes keep working.
+struct __attribute__((packed)) BleStatusNotification {
+    TelemetryFrame frame;
+    uint16_t ackSeq;            // seq of the newest binary write settled
+    uint8_t ackStatus;          // BleAckStatus
+};
+
+static_assert(sizeof(BleStatusNotification) == 17, "BleStatusNotification layout changed");
+
+// Per connected central, for /api/ble
+struct BleConnectionStats {
+    uint16_t connHandle;
+    uint16_t mtu;
+    uint16_t interval;          // Connection interval (1.25 ms units)
+    uint16_t latency;           // Slave latency (connection events)
+    bool activeParams;          // Short interval requested (central is driving)
+    uint32_t commands;          // Command writes
+    uint32_t binaryCommands;    // ... of which binary
+    uint32_t rejectedCommands;  // Malformed or stale binary writes
+    uint32_t notifies;
+    uint32_t notifyFailures;    // No buffers; retried with the newest frame
+    uint32_t notifySkipped;     // Frames dropped while congested
+    uint32_t latencySamples;
+    uint32_t lastLatencyUs;     // Binary command write -> first notify acking it as applied
+    uint32_t avgLatencyUs;      // Exponential moving average
+    uint32_t maxLatencyUs;
+};
 
 // True BLE (Bluetooth Low Energy) interface using NimBLE
 void initBLEInterface();
 void updateBLEInterface();
 
+// Connection slots (CONFIG_BT_NIMBLE_MAX_CONNECTIONS); false for an unused slot
+int getBleConnectionCount();
+bool getBleConnectionStats(int index, BleConnectionStats& out);
+
 // Bluetooth Classic SPP interface (legacy, for serial terminal apps)
 void initBluetoothClassic();
 void updateBluetoothClassic();
@@ -0,0 +1,113 @@
+#ifndef COMMAND_BUS_H
+#define COMMAND_BUS_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Commands accepted by the control task
+enum CommandType : uint8_t {
+    CMD_SET_SPEED,              // value = target speed (0-100%)
+    CMD_ADJUST_SPEED,           // value = delta added to the current target
+    CMD_SET_DIRECTION,          // value != 0 -> forward
+    CMD_TOGGLE_DIRECTION,       // Flip target direction (only while enabled)
+    CMD_FIRE,                   // value != 0 -> start firing, 0 -> stop
+    CMD_EMERGENCY_STOP,
+    CMD_CLEAR_EMERGENCY_STOP,
+    CMD_SET_ENABLED,            // value != 0 -> enabled
+};
+
+// Where a command came from
+enum CommandSource : uint8_t {
+    SOURCE_PHYSICAL,
+    SOURCE_SERIAL,
+    SOURCE_BLE,
+    SOURCE_SPP,
+    SOURCE_WEB,
+    SOURCE_UDP,
+    SOURCE_COUNT
+};
+
+struct Command {
+    CommandType type;
+    CommandSource source;
+    float value;
+    uint32_t timestampUs;       // micros() when the command was posted
+};
+
+// Which fields of a Setpoint are set
+enum SetpointField : uint8_t {
+    SETPOINT_SPEED = 1 << 0,
+    SETPOINT_DIRECTION = 1 << 1,
+    SETPOINT_FIRE = 1 << 2,
+};
+
+// Complete control state from a remote client. Each client numbers its updates;
+// older ones are discarded and a burst is coalesced to the newest per tick.
+struct Setpoint {
+    uint32_t clientId;
+    uint32_t seq;               // Increments with every update from this client
+    uint32_t clientTimeMs;      // Client clock, must not go backwards
+    uint8_t fields;             // SetpointField mask
+    float speed;
+    bool forward;
+    bool fire;
+};
+
+// Applied-seq record owned by one connection (a BLE central). The control task
+// fills it in as it applies that client's setpoints, so the connection's ack
+// doesn't depend on the client keeping its slot in the ordering table.
+struct SetpointAck {
+    uint32_t clientId;
+    uint32_t appliedSeq;        // Newest applied seq, including updates coalesced into a later one
+    bool hasApplied;
+};
+
+enum SetpointResult : uint8_t {
+    SETPOINT_ACCEPTED,
+    SETPOINT_STALE,             // Not newer than the last update from this client
+};
+
+struct CommandBusStats {
+    uint32_t posted[SOURCE_COUNT];
+    uint32_t applied;
+    uint32_t dropped;           // Rejected because the queue was full
+    uint32_t depth;             // Commands drained on the last tick
+    uint32_t maxDepth;
+    uint32_t lastLatencyUs;     // Post -> applied by the control task
+    uint32_t maxLatencyUs;
+    uint32_t avgLatencyUs;      // Exponential moving average
+    uint32_t setpointsAccepted;
+    uint32_t setpointsStale;    // Discarded as out of order
+    uint32_t setpointsApplied;  // Accepted minus those coalesced within a tick
+};
+
+void initCommandBus();
+
+// Enqueue a command from any task (lock-free, never blocks).
+// Returns false if the queue is full.
+bool postCommand(CommandType type, CommandSource source, float value = 0.0f);
+
+// Replace the pending setpoint if it is newer than the last one from the same
+// client (any task, never blocks for long). Last writer wins across clients.
+// Clients are tracked per source, so ids only need to be unique per transport.
+// If ack is given, it is filled in once the control task has applied the update.
+SetpointResult postSetpoint(const Setpoint& setpoint, CommandSource source, SetpointAck* ack = nullptr);
+
+// Bind an ack record to a client and clear it (any task)
+void resetSetpointAck(SetpointAck& ack, uint32_t clientId);
+
+// Newest applied seq in the record; false if none has been applied yet (any task)
+bool getSetpointAck(const SetpointAck& ack, uint32_t& seq);
+
+// Drain and apply all queued commands, then the newest pending setpoint
+// (control task only, once per tick)
+void processCommands();
+
+CommandBusStats getCommandBusStats();
+
+// Zero every counter, average and maximum (any task). The control task's own
+// figures (applied, depth, latency, setpoints applied) clear on its next tick.
+void resetCommandBusStats();
+const char* getCommandSourceName(CommandSource source);
+
+#endif // COMMAND_BUS_H
@@ -0,0 +1,70 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "command_bus.h"
+
+// Shared text command grammar for serial, SPP, BLE and web:
+//   +  -          Speed up/down by SPEED_INCREMENT
+//   S<number>     Set speed (e.g. S42.5)
+//   D  R          Direction forward / reverse
+//   F  f          Start / stop firing thrusters
+//   X  C          Emergency stop / clear emergency stop
+//   L<number>     Runtime log level (0 none ... 5 trace)
+//   P<number>     Radio profile (radio_profile.h), restarts the device
+//   ?             Status query (handled by the transport)
+// Commands may be batched with ';', ',' or whitespace (e.g. "S50;D;F").
+// Letters other than F/f are case-insensitive. The commands of a token (text
+// between separators, e.g. "S50D") are handed on once the token ends; a
+// malformed token ("S-5", "S5q", "+Q") is counted as an error and none of it
+// is applied.
+
+#define COMMAND_PARSER_MAX_NUMBER 8
+#define COMMAND_PARSER_MAX_TOKEN_OPS 8  // Commands in one token without a separator
+
+struct ParsedCommand {
+    char op;            // Canonical op character ('S', 'D', 'f', ...)
+    float value;        // Numeric argument (S and L)
+};
+
+typedef void (*ParsedCommandHandler)(const ParsedCommand& cmd, void* context);
+
+// Incremental parser over a fixed buffer - never allocates
+class CommandParser {
+public:
+    CommandParser(ParsedCommandHandler handler, void* context = nullptr);
+
+    void feed(char c);
+    void feed(const char* data, size_t length);
+
+    // End of input (end of a BLE write, serial idle timeout) - ends the current token
+    void flush();
+
+    bool hasPending() const { return pendingOp != 0 || tokenLength > 0; }
+    uint32_t getCommandCount() const { return commandCount; }
+    uint32_t getErrorCount() const { return errorCount; }
+
+private:
+    ParsedCommandHandler handler;
+    void* context;
+    char pendingOp;
+    char number[COMMAND_PARSER_MAX_NUMBER + 1];
+    uint8_t numberLength;
+    ParsedCommand token[COMMAND_PARSER_MAX_TOKEN_OPS];     // Held until the token ends
+    uint8_t tokenLength;
+    bool discarding;        // Skipping the rest of a malformed token
+    uint32_t commandCount;
+    uint32_t errorCount;
+
+    void queue(char op, float value);
+    void reject();
+    bool completePending();
+    void endToken();
+};
+
+// Post a parsed command to the command bus. Returns false for ops the
+// bus doesn't handle ('?'), if the queue is full or for an unknown radio profile.
+bool postParsedCommand(const ParsedCommand& cmd, CommandSource source);
+
+#endif // COMMAND_PARSER_H
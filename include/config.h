@@ -24,11 +24,88 @@
 
 // Timing constants
 #define ACCELERATION_UPDATE_MS 50   // Update acceleration every 50ms
-#define PHYSICAL_INPUT_DEBOUNCE_MS 50  // Debounce time for buttons/switches
+#define PHYSICAL_INPUT_DEBOUNCE_MS 50  // Minimum time between accepted changes of one button/switch
+#define PHYSICAL_INPUT_SETTLE_MS 10    // Input must be quiet this long after an edge before it is read
+#define PHYSICAL_INPUT_RESYNC_MS 100   // Re-read idle inputs this often in case an edge was missed
+
+// Speed potentiometer acquisition (continuous ADC1 DMA)
+#define SPEED_POT_SAMPLE_RATE_HZ 20000 // DMA sample rate (ESP32 minimum is 20 kHz)
+#define SPEED_POT_FILTER_SHIFT 3       // IIR smoothing: y += (x - y) / 2^shift per control tick
+#define SPEED_POT_DEADBAND 0.5f        // Minimum filtered change (%) before the target is updated
+#define SPEED_POT_MIN_MV 150           // Calibrated voltage at the pot's 0% end stop
+#define SPEED_POT_MAX_MV 3100          // Calibrated voltage at the pot's 100% end stop
 #define SERIAL_COMMAND_TIMEOUT_MS 1000 // Timeout for serial command processing
+#define SERIAL_TX_BUFFER_SIZE 1024     // UART TX ring the log sink writes into
+
+// Task scheduling (FreeRTOS) - control path runs alone on core 1, radios/UI on core 0
+#define CONTROL_TASK_PERIOD_MS 2       // Control loop period (500 Hz): inputs -> ramp -> outputs
+#define CONTROL_TASK_PRIORITY 10       // Highest application priority
+#define CONTROL_TASK_CORE 1            // Application core
+#define CONTROL_TASK_STACK_SIZE 4096
+#define NETWORK_TASK_PERIOD_MS 10      // WiFi/OTA servicing (100 Hz)
+#define NETWORK_TASK_PRIORITY 2
+#define NETWORK_TASK_STACK_SIZE 8192
+#define COMMS_TASK_PERIOD_MS 10        // Serial/BLE/SPP servicing (100 Hz)
+#define COMMS_TASK_PRIORITY 1
+#define COMMS_TASK_STACK_SIZE 6144
+#define COMMS_TASK_CORE 0              // Protocol core (radio stacks live here)
+
+// Command bus (all transports -> control task)
+#define COMMAND_QUEUE_SIZE 32          // Bounded MPSC ring capacity (power of two)
+#define COMMAND_MAX_BYTES_PER_TICK 128 // Input bytes parsed per stream transport per comms tick
+#define SETPOINT_CLIENT_SLOTS_BLE CONFIG_BT_NIMBLE_MAX_CONNECTIONS // Setpoint ordering slots per transport,
+#define SETPOINT_CLIENT_SLOTS_WEB WS_MAX_CLIENTS   // sized to its client limit so transports never
+#define SETPOINT_CLIENT_SLOTS_UDP UDP_MAX_CLIENTS  // evict each other (LRU within a transport)
+
+// Log sinks
+#define SPP_LOG_BACKLOG 16             // Log records queued for an SPP terminal
+// Set LOG_SYSLOG_HOST (e.g. -DLOG_SYSLOG_HOST=\"192.168.1.10\") to forward logs over UDP syslog
+#ifndef LOG_SYSLOG_PORT
+#define LOG_SYSLOG_PORT 514
+#endif
+#define LOG_SYSLOG_BACKLOG 32
+
+// Crash log (RTC no-init memory, survives panics, watchdog and brownout resets)
+#define CRASH_LOG_RECORDS 24           // Last log lines kept across a reset
+#define CRASH_LOG_TEXT_LENGTH 80       // Characters kept per line
+#define CRASH_LOG_STATE_INTERVAL_MS 100 // State snapshot refresh period
+
+// WiFi state machine (see wifi_manager.h)
+#define WIFI_CONNECT_TIMEOUT_MS 15000  // One association + DHCP attempt
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 2000  // Directed attempt (cached BSSID/channel) before a full scan
+#define WIFI_FAST_CONNECT_STATIC_IP 0  // 1 = reuse the cached lease without DHCP (only with a DHCP reservation)
+#define WIFI_BACKOFF_MIN_MS 500        // First retry delay, doubled per failure
+#define WIFI_BACKOFF_MAX_MS 30000
+#define WIFI_AP_FALLBACK_MS 30000      // Offline this long -> setup AP next to the station
+#define WIFI_AP_LINGER_MS 30000        // Keep the setup AP after connecting while stations use it
+#define WIFI_AP_RETRY_MS 5000          // SoftAP start failed -> try again
 
 // Web server
 #define WEB_SERVER_PORT 80
+#define WS_STATE_MIN_INTERVAL_MS 20    // Minimum spacing of WebSocket state pushes
+#define WS_STATE_HEARTBEAT_MS 1000     // Push unchanged state this often (liveness)
+#define WS_MAX_CLIENTS 4               // Oldest WebSocket clients beyond this are closed
+#define STATE_JSON_MAX_LENGTH 256      // Cached /api/state and /ws state JSON buffer
+
+// UDP control channel (STA mode only)
+#define UDP_CONTROL_PORT 4210
+#define UDP_STATE_INTERVAL_MS 20       // State datagrams to each client (50 Hz)
+#define UDP_CONTROL_TIMEOUT_MS 500     // Silent client -> failsafe stop and dropped (send every <= 100 ms)
+#define UDP_MAX_CLIENTS 2              // Clients receiving state datagrams
+
+// Telemetry hub (see telemetry.h)
+#define TELEMETRY_MAX_SUBSCRIBERS 8    // 3 BLE centrals, WebSocket, SPP, serial + spare
+#define SPP_TELEMETRY_MIN_INTERVAL_MS 1000
+#define SPP_TELEMETRY_HEARTBEAT_MS 5000
+#define SERIAL_TELEMETRY_MIN_INTERVAL_MS 1000
+#define SERIAL_TELEMETRY_HEARTBEAT_MS 5000
+#define TEXT_TELEMETRY_SPEED_DEADBAND 10    // 1 % for human-readable status lines
+
+// Radio profile (see radio_profile.h)
+#define RADIO_DEFAULT_PROFILE 0             // "all": WiFi + BLE + SPP
+#define RADIO_RESTART_DELAY_MS 1000         // Lets the reply and log lines go out before the restart
+#define RADIO_METRICS_SAMPLE_INTERVAL_MS 1000
+#define RADIO_METRICS_SAVE_INTERVAL_MS 600000   // 10 min - limits NVS wear
 
 // Bluetooth Classic (SPP)
 #define BT_CLASSIC_DEVICE_NAME "SpaceTornado-SPP"
@@ -38,5 +115,18 @@
 #define BLE_SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
 #define BLE_COMMAND_CHAR_UUID   "beb5483e-36e1-4688-b7f5-ea07361b26a8"
 #define BLE_STATUS_CHAR_UUID    "beb5483f-36e1-4688-b7f5-ea07361b26a9"
-#define BLE_STATUS_NOTIFY_INTERVAL_MS 500
+#define BLE_TELEMETRY_MIN_INTERVAL_MS 20    // Max notify rate per central (50 Hz)
+#define BLE_TELEMETRY_HEARTBEAT_MS 1000     // Notify unchanged state this often
+#define BLE_TELEMETRY_SPEED_DEADBAND 5      // 0.5 % current-speed deadband (0.1 % units)
+#define BLE_MTU 185                         // Requested ATT MTU
+#define BLE_ACTIVE_MIN_INTERVAL 6           // 7.5 ms connection interval while driving (1.25 ms units)
+#define BLE_ACTIVE_MAX_INTERVAL 12          // 15 ms
+#define BLE_IDLE_MIN_INTERVAL 24            // 30 ms when idle
+#define BLE_IDLE_MAX_INTERVAL 48            // 60 ms
+#define BLE_IDLE_SLAVE_LATENCY 4            // Connection events the device may skip when idle
+#define BLE_SUPERVISION_TIMEOUT 400         // 4 s (10 ms units)
+#define BLE_IDLE_AFTER_MS 3000              // No command writes for this long -> idle parameters
+#define BLE_NOTIFY_RETRY_MS 20              // Retry after a notify failed for lack of buffers
+#define BLE_COMMAND_MAX_OPS 8               // Queued opcodes (adjust, e-stop, clear) per binary write
+#define BLE_SETPOINT_CLIENT_ID 0x424C0000   // "BL" + 16-bit connection counter (command bus client id)
 
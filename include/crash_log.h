@@ -0,0 +1,35 @@
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+#include <stdint.h>
+#include "config.h"
+#include "logging.h"
+
+// What the previous boot left behind in RTC memory
+struct PreviousSession {
+    bool valid;                 // False after a power-on reset or if the data failed its checksum
+    const char* resetReason;    // Why the previous session ended (esp_reset_reason of this boot)
+    bool stateValid;
+    uint32_t uptimeMs;          // Last snapshot before the reset
+    float targetSpeed;
+    float currentSpeed;
+    bool direction;
+    bool enabled;
+    bool firingThrusters;
+    bool emergencyStop;
+    uint32_t minFreeHeap;
+    uint8_t recordCount;
+};
+
+// Recover the previous session and start mirroring this one (call right after Logger.begin())
+void initCrashLog();
+
+// Refresh the state snapshot (comms task)
+void updateCrashLog();
+
+const PreviousSession& getPreviousSession();
+
+// Recovered log lines, index 0 = newest
+bool getPreviousSessionRecord(int index, LogRecord& out);
+
+#endif // CRASH_LOG_H
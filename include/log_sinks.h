@@ -0,0 +1,10 @@
+#ifndef LOG_SINKS_H
+#define LOG_SINKS_H
+
+#include "logging.h"
+
+// Registers the network log sinks enabled at build time (UDP syslog when
+// LOG_SYSLOG_HOST is defined). Serial and SPP sinks are added by their interfaces.
+void initLogSinks();
+
+#endif // LOG_SINKS_H
@@ -5,37 +5,317 @@
 #include <Print.h>
 #include <WString.h>
 
-#define LOG_BUFFER_SIZE 100
+#define LOG_ARENA_SIZE 16384        // Bytes of record storage (preallocated, never grows)
+#define LOG_INDEX_SIZE 256          // Maximum records retained (power of two)
 #define MAX_LOG_MESSAGE_LENGTH 256
+#define LOG_WRITER_SLOTS 6          // Tasks that can assemble a line concurrently
+
+// Output sinks, fed asynchronously from the record ring by a background task
+#define LOG_MAX_SINKS 6
+#define LOG_DEFAULT_SINK_BACKLOG 64 // Records a sink may fall behind before the oldest are dropped
+#define LOG_DRAIN_TASK_PRIORITY 1
+#define LOG_DRAIN_TASK_CORE 0
+#define LOG_DRAIN_TASK_STACK_SIZE 4096
+#define LOG_DRAIN_IDLE_MS 100       // Re-check sinks that weren't ready this often
+#define LOG_DRAIN_RETRY_MS 5        // ...or this often while a sink has output pending
+
+// Deferred (binary) logging: LOG_FAST stores the format pointer and raw arguments
+// and formats only when the record is read. Set to 0 to format immediately.
+#ifndef LOG_DEFERRED_FORMATTING
+#define LOG_DEFERRED_FORMATTING 1
+#endif
+#define LOG_DEFERRED_MAX_PAYLOAD 96 // Bytes of packed arguments per record
+#define LOG_DEFERRED_MAX_STRING 32  // String arguments are copied, truncated to this length
+
+// Log levels
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+// Compile-time ceiling for the whole build (e.g. -DLOG_LEVEL=LOG_LEVEL_WARN in build_flags).
+// Calls above it compile to nothing and their arguments are never evaluated.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Per-module override: #define LOG_LOCAL_LEVEL before any #include in a .cpp file
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL LOG_LEVEL
+#endif
+
+// Runtime level at boot; change with Logger.setLevel() (serial "L<n>", /api/loglevel)
+#ifndef LOG_DEFAULT_RUNTIME_LEVEL
+#define LOG_DEFAULT_RUNTIME_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Copy of one log record, filled by readRecord()
+struct LogRecord {
+    uint32_t seq;                   // Monotonic sequence number
+    uint32_t timestampMs;           // millis() when the line was completed
+    uint16_t length;
+    bool deferred;                  // Stored in binary form, formatted on read
+    char text[MAX_LOG_MESSAGE_LENGTH + 1];  // NUL-terminated
+};
+
+// Packs LOG_FAST arguments as [type][value] pairs after the format pointer
+class LogArgPacker {
+public:
+    enum ArgType : uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_STRING, ARG_POINTER };
+
+    uint8_t data[LOG_DEFERRED_MAX_PAYLOAD];
+    uint16_t length;
+
+    explicit LogArgPacker(const char* format) : length(0) { put(&format, sizeof(format)); }
+
+    void add(int value)                { addInt(value); }
+    void add(long value)               { addInt(value); }
+    void add(long long value)          { addInt(value); }
+    void add(unsigned int value)       { addUint(value); }
+    void add(unsigned long value)      { addUint(value); }
+    void add(unsigned long long value) { addUint(value); }
+    void add(bool value)               { addInt(value ? 1 : 0); }
+    void add(char value)               { addInt(value); }
+    void add(double value)             { if (reserve(1 + sizeof(value))) { data[length++] = ARG_DOUBLE; put(&value, sizeof(value)); } }
+    void add(const void* value)        { if (reserve(1 + sizeof(value))) { data[length++] = ARG_POINTER; put(&value, sizeof(value)); } }
+    void add(const char* value);
+
+private:
+    bool reserve(size_t size) { return length + size <= sizeof(data); }
+    void put(const void* value, size_t size) { memcpy(&data[length], value, size); length += size; }
+    void addInt(long long value)       { if (reserve(1 + sizeof(value))) { data[length++] = ARG_INT; put(&value, sizeof(value)); } }
+    void addUint(unsigned long long value) { if (reserve(1 + sizeof(value))) { data[length++] = ARG_UINT; put(&value, sizeof(value)); } }
+};
+
+inline void packLogArgs(LogArgPacker&) {}
+
+template <typename T, typename... Rest>
+inline void packLogArgs(LogArgPacker& packer, T first, Rest... rest) {
+    packer.add(first);
+    packLogArgs(packer, rest...);
+}
+
+// Destination for log output. Each sink is a cursor into the shared record ring,
+// so queueing costs nothing per sink; a sink that falls more than maxBacklog
+// records behind (or behind the ring's eviction) skips its oldest records.
+// Sink methods only run on the drain task and must not block for long.
+class LogSink {
+public:
+    LogSink(const char* name, uint16_t maxBacklog = LOG_DEFAULT_SINK_BACKLOG) :
+        name(name), maxBacklog(maxBacklog), cursor(0), sent(0), dropped(0) {}
+    virtual ~LogSink() {}
+
+    // False while the destination is unavailable (records wait, up to maxBacklog)
+    virtual bool isReady() { return true; }
+
+    // Accept one record; return false to have it offered again later
+    virtual bool writeRecord(const LogRecord& record) = 0;
+
+    // Push out previously accepted output; true once nothing is pending
+    virtual bool flushPending() { return true; }
+
+    const char* getName() const { return name; }
+
+private:
+    friend class LoggerClass;
+    const char* name;
+    uint16_t maxBacklog;
+    uint32_t cursor;                // Next record this sink needs
+    uint32_t sent;
+    uint32_t dropped;
+};
+
+// Sink for a Print stream (UART, SPP). Lines are written only as far as
+// availableForWrite() allows, so a full TX buffer never blocks the drain task.
+class PrintSink : public LogSink {
+public:
+    PrintSink(const char* name, Print& print, uint16_t maxBacklog = LOG_DEFAULT_SINK_BACKLOG, bool checkSpace = true);
+
+    bool writeRecord(const LogRecord& record) override;
+    bool flushPending() override;
+
+protected:
+    Print& print;
+
+private:
+    bool checkSpace;                // False for streams that don't implement availableForWrite()
+    uint16_t lineLength;
+    uint16_t linePos;
+    char line[MAX_LOG_MESSAGE_LENGTH + 2];
+};
+
+struct LogSinkStats {
+    const char* name;
+    uint32_t sent;                  // Records delivered
+    uint32_t dropped;               // Records skipped (backlog limit or evicted)
+    uint32_t backlog;               // Records waiting
+};
+
+struct LogStats {
+    uint32_t records;               // Records currently retained
+    uint32_t bytesUsed;             // Arena bytes held by retained records
+    uint32_t written;               // Records written since boot
+    uint32_t evicted;               // Records overwritten by newer ones
+    uint32_t truncated;             // Lines cut at MAX_LOG_MESSAGE_LENGTH
+};
 
 class LoggerClass : public Print {
 private:
-    Print* serialPrint;
-    String logBuffer[LOG_BUFFER_SIZE];
-    int logIndex;
-    int logCount;
-    char messageBuffer[MAX_LOG_MESSAGE_LENGTH];
-    int bufferPos;
+    // Stored in the arena ahead of each record's text
+    struct RecordHeader {
+        uint32_t seq;
+        uint32_t timestampMs;
+        uint16_t length;
+        uint16_t flags;
+    };
+
+    enum RecordFlags : uint16_t { RECORD_DEFERRED = 1 << 0 };
+
+    // Partial line being assembled by one task
+    struct LineBuffer {
+        void* owner;
+        uint16_t length;
+        char text[MAX_LOG_MESSAGE_LENGTH];
+    };
+
+    uint8_t arena[LOG_ARENA_SIZE];
+    uint16_t recordOffsets[LOG_INDEX_SIZE];    // Arena offset of record seq, indexed by seq % LOG_INDEX_SIZE
+    uint32_t firstSeq;                         // Oldest retained record
+    uint32_t nextSeq;                          // Sequence number of the next record
+    uint32_t head;                             // Arena offset where the next record goes
+    uint32_t bytesUsed;
+    uint32_t evictedCount;
+    uint32_t truncatedCount;
+    volatile uint8_t runtimeLevel;
+
+    LineBuffer lineBuffers[LOG_WRITER_SLOTS];
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    LogSink* sinks[LOG_MAX_SINKS];
+    volatile uint8_t sinkCount;
+    TaskHandle_t drainTask;
 
 public:
     LoggerClass();
-    
-    void addLogger(Print& print);
-    
+
+    // Start the background task that feeds the sinks (records are buffered until then)
+    void begin();
+
+    // Register an output; duplicates are ignored. A new sink starts at the oldest retained record.
+    bool addSink(LogSink& sink);
+    int getSinkCount();
+    LogSinkStats getSinkStats(int index);
+
+    // Runtime filtering for the LOG_* macros
+    void setLevel(uint8_t level);
+    uint8_t getLevel() const { return runtimeLevel; }
+    bool isLevelEnabled(uint8_t level) const { return level <= runtimeLevel; }
+    static const char* getLevelName(uint8_t level);
+
     size_t write(uint8_t byte) override;
     size_t write(const uint8_t* buffer, size_t size) override;
-    
-    String getLogsAsHtml();
-    String getLogsAsJson();
-    
+
+    // Formats into a stack buffer instead of Print::printf's heap fallback
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    // Binary record: format pointer + raw arguments, formatted on read (use LOG_FAST)
+    template <typename... Args>
+    void logDeferred(const char* format, Args... args) {
+        LogArgPacker packer(format);
+        packLogArgs(packer, args...);
+        commitRecord((const char*)packer.data, packer.length, RECORD_DEFERRED);
+    }
+
+    // Compile-time format checking for LOG_FAST (never called)
+    __attribute__((format(printf, 1, 2))) static void checkFormat(const char*, ...) {}
+
+    // Record access - safe from any task
+    uint32_t getFirstSeq();
+    uint32_t getNextSeq();
+    bool readRecord(uint32_t seq, LogRecord& out);
+    LogStats getStats();
+
     void clearLogs();
-    int getLogCount() const { return logCount; }
-    
+    int getLogCount();
+
 private:
-    void addMessageToBuffer(const String& message);
+    LineBuffer* acquireLineBuffer();
+    void releaseLineBuffer(LineBuffer* line);
+    void appendToLine(LineBuffer* line, const uint8_t* data, size_t size);
+    void commitRecord(const char* data, uint16_t length, uint16_t flags = 0);
+    static uint32_t recordSize(uint16_t length);
+    static uint16_t formatDeferred(const uint8_t* payload, uint16_t length, char* out, size_t outSize);
+    static void drainTaskMain(void* parameter);
+    bool drainSink(LogSink& sink, LogRecord& record);
 };
 
 extern LoggerClass Logger;
 
-#endif // LOGGING_H
+enum LogStreamFormat { LOG_STREAM_HTML, LOG_STREAM_JSON };
+
+// Renders the log ring incrementally for a chunked HTTP response: each read()
+// fills as much of the caller's buffer as it can, pulling one record at a time,
+// so memory use is fixed regardless of LOG_ARENA_SIZE.
+//   HTML: newest first, followed by the previous session recovered from the crash log.
+//   JSON: {"logs":[{"seq":..,"t":..,"msg":".."},...],"next":..,"first":..,"dropped":..,...}
+//         oldest first, starting at sequence number 'since' (the previous response's "next").
+class LogStreamRenderer {
+public:
+    explicit LogStreamRenderer(LogStreamFormat format, uint32_t since = 0);
+
+    // Returns bytes written; 0 once the response is complete
+    size_t read(uint8_t* buffer, size_t maxLen);
+
+private:
+    enum Stage { STAGE_HEADER, STAGE_STATS, STAGE_RECORDS, STAGE_PREVIOUS, STAGE_PREVIOUS_RECORDS, STAGE_FOOTER, STAGE_DONE };
+
+    LogStreamFormat format;
+    Stage stage;
+    uint32_t firstSeq;
+    uint32_t endSeq;
+    uint32_t seq;                   // HTML: records below this are still to be sent; JSON: next record to send
+    uint32_t shown;
+    uint32_t dropped;               // JSON: records evicted before they could be sent
+    int previousIndex;              // HTML: next recovered crash-log line
 
+    const char* piece;              // Text being copied out (static or staging)
+    size_t pieceLength;
+    size_t piecePos;
+
+    LogRecord record;
+    char staging[MAX_LOG_MESSAGE_LENGTH * 6 + 64];   // One record, worst-case escaped
+
+    bool nextPiece();
+    void setPiece(const char* text, size_t length);
+    size_t appendEscaped(size_t used, const char* text);
+};
+
+// Leveled logging. Formats are string literals without the trailing newline.
+#define LOG_AT(level, format, ...) do { \
+        if ((level) <= LOG_LOCAL_LEVEL && Logger.isLevelEnabled(level)) { \
+            Logger.printf(format "\n", ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(format, ...) LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...)  LOG_AT(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...)  LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_DEBUG(format, ...) LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define LOG_TRACE(format, ...) LOG_AT(LOG_LEVEL_TRACE, format, ##__VA_ARGS__)
+
+// Hot-path logging: a few hundred ns instead of printf formatting on the caller.
+// The format must be a string literal (its pointer is stored, not its contents).
+#if LOG_DEFERRED_FORMATTING
+#define LOG_FAST(level, format, ...) do { \
+        if ((level) <= LOG_LOCAL_LEVEL && Logger.isLevelEnabled(level)) { \
+            if (false) LoggerClass::checkFormat(format, ##__VA_ARGS__); \
+            Logger.logDeferred("" format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define LOG_FAST(level, format, ...) LOG_AT(level, format, ##__VA_ARGS__)
+#endif
+
+#endif // LOGGING_H
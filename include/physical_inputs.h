@@ -1,10 +1,23 @@
 #ifndef PHYSICAL_INPUTS_H
 #define PHYSICAL_INPUTS_H
 
+#include <stdint.h>
 #include "config.h"
 
+// Debounce and latency statistics for one button/switch
+struct PhysicalInputStats {
+    const char* name;
+    bool level;                 // Debounced pin level (HIGH = released/off)
+    uint32_t edges;             // Raw edges seen by the interrupt
+    uint32_t changes;           // Debounced level changes
+    uint32_t lastLatencyUs;     // First edge -> command posted
+    uint32_t maxLatencyUs;
+};
+
 void initPhysicalInputs();
 void updatePhysicalInputs();
 
-#endif // PHYSICAL_INPUTS_H
+int getPhysicalInputCount();
+PhysicalInputStats getPhysicalInputStats(int index);
 
+#endif // PHYSICAL_INPUTS_H
@@ -0,0 +1,54 @@
+#ifndef RADIO_PROFILE_H
+#define RADIO_PROFILE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Which radio stacks are brought up at boot. The profile is persisted in NVS.
+// Controller memory of unused Bluetooth modes is released before any stack
+// starts and cannot be reclaimed at runtime, so a change applies after a restart.
+enum RadioStack : uint8_t {
+    RADIO_WIFI = 1 << 0,        // Web interface, WebSocket, UDP control, OTA
+    RADIO_BLE = 1 << 1,         // NimBLE (Web Bluetooth)
+    RADIO_SPP = 1 << 2,         // Bluetooth Classic SPP (Bluedroid)
+};
+
+struct RadioProfile {
+    const char* name;
+    uint8_t stacks;             // RadioStack mask
+};
+
+// Most recent run of a profile, kept in NVS so profiles can be compared
+struct RadioProfileMetrics {
+    uint32_t boots;             // Boots into this profile
+    uint32_t uptimeS;           // Length of the most recent run
+    uint32_t bootFreeHeap;      // Free heap once setup() has finished
+    uint32_t freeHeap;          // Latest sample
+    uint32_t minFreeHeap;       // Low-water mark of the run
+    uint32_t largestFreeBlock;  // Latest sample
+    uint32_t controlJitterMaxUs;
+    uint32_t commandLatencyMaxUs;   // Post -> applied by the control task
+    uint32_t bleLatencyAvgUs;       // BLE command write -> notify (0 = no samples)
+};
+
+// Load the persisted profile and release memory of unused Bluetooth modes
+// (setup(), before any radio is initialized)
+void initRadioProfile();
+
+// Sample metrics, save them periodically, restart into a newly selected profile (network task)
+void updateRadioProfile();
+
+bool isRadioEnabled(RadioStack stack);
+
+int getRadioProfileCount();
+const RadioProfile& getRadioProfile(int index);
+int findRadioProfile(const char* name);     // -1 if unknown
+int getActiveRadioProfile();
+int getPendingRadioProfile();               // -1 unless a restart is scheduled
+bool getRadioProfileMetrics(int index, RadioProfileMetrics& out);   // False if never run
+
+// Persist a profile and restart into it after RADIO_RESTART_DELAY_MS (any task).
+// Returns false for an unknown index.
+bool setRadioProfile(int index);
+
+#endif // RADIO_PROFILE_H
@@ -2,6 +2,7 @@
 #define ROCKET_STATE_H
 
 #include "config.h"
+#include <stdint.h>
 
 struct RocketState {
     // Target values (set by inputs)
@@ -34,7 +35,23 @@ struct RocketState {
     {}
 };
 
-// Global state instance
+// Consistent copy of the state for readers on other tasks (web, BLE, SPP, serial)
+struct RocketStateSnapshot {
+    float targetSpeed;
+    float currentSpeed;
+    float approximateVelocity;
+    bool targetDirection;
+    bool currentDirection;
+    bool enabled;
+    bool firingThrusters;
+    bool emergencyStop;
+    uint32_t changedAtMs;       // millis() when the published state last changed
+    uint32_t version;           // Incremented on every change at the published resolution
+    
+    bool isActive() const { return enabled && !emergencyStop; }
+};
+
+// Global state instance (owned by the control task)
 extern RocketState rocketState;
 
 // State management functions
@@ -55,5 +72,10 @@ bool isFiringThrusters();
 bool isEmergencyStop();
 float getApproximateVelocity();
 
+// Snapshot publishing - publishRocketState() is called only by the control task,
+// getRocketStateSnapshot() is lock-free and safe from any task
+void publishRocketState();
+RocketStateSnapshot getRocketStateSnapshot();
+
 #endif // ROCKET_STATE_H
 
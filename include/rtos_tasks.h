@@ -0,0 +1,29 @@
+#ifndef RTOS_TASKS_H
+#define RTOS_TASKS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Timing statistics for a fixed-rate task (all times in microseconds)
+struct TaskTimingStats {
+    const char* name;
+    uint32_t periodUs;          // Configured period
+    uint32_t lastPeriodUs;      // Measured start-to-start period
+    uint32_t maxPeriodUs;
+    uint32_t lastJitterUs;      // |measured period - configured period|
+    uint32_t maxJitterUs;
+    uint32_t lastRunUs;         // Time spent in the task body
+    uint32_t maxRunUs;
+    uint32_t missedDeadlines;   // Wake-ups that were already late
+    uint32_t iterations;
+};
+
+// Start the control, network and comms tasks (call at the end of setup())
+void startRtosTasks();
+
+// Timing statistics access
+int getTaskCount();
+TaskTimingStats getTaskStats(int index);
+void resetTaskStats();
+
+#endif // RTOS_TASKS_H
@@ -0,0 +1,58 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Single-writer sequence lock. The writer never blocks; readers on any task
+// or core retry until they observe a copy that no write overlapped.
+// T must be trivially copyable (plain struct of scalars).
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : sequence(0) {
+        memset(&data, 0, sizeof(data));
+    }
+
+    // Only one task may call write()
+    void write(const T& value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);   // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &value, sizeof(T));
+        sequence.store(seq + 2, std::memory_order_release);   // even: stable
+    }
+
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            memcpy(&copy, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+            if (before == after) {
+                break;
+            }
+        } while (true);
+        return copy;
+    }
+
+    // Number of completed writes
+    uint32_t writeCount() const {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    std::atomic<uint32_t> sequence;
+    T data;
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,27 @@
+#ifndef SPEED_POT_H
+#define SPEED_POT_H
+
+#include <stdint.h>
+#include "config.h"
+
+struct SpeedPotStats {
+    const char* calibration;    // eFuse calibration source used
+    uint32_t samples;           // ADC conversions consumed
+    uint32_t overruns;          // DMA pool overflows (samples lost)
+    uint16_t lastRaw;           // Oversampled raw reading of the last frame
+    uint32_t millivolts;        // Filtered, calibrated voltage
+    float percent;              // Last reported speed setpoint
+    uint32_t updates;           // Setpoint changes reported
+};
+
+// Start continuous DMA sampling of PIN_SPEED_POT
+void initSpeedPot();
+
+// Consume new samples and filter them (control task, once per tick).
+// Returns true and sets percent when the filtered setpoint moved past the
+// deadband, or when force is set (e.g. the system was just enabled).
+bool readSpeedPot(float& percent, bool force = false);
+
+SpeedPotStats getSpeedPotStats();
+
+#endif // SPEED_POT_H
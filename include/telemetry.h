@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Versioned binary state frame, encoded once per change and shared by
+// every transport (BLE notify, /api/telemetry; text for serial and SPP).
+// Transports subscribe to the hub with their own rate and change filters
+// instead of sampling the state on timers.
+// Little-endian. Decoders accept longer frames so fields can be appended.
+#define TELEMETRY_FRAME_VERSION 1
+
+enum TelemetryFlags : uint8_t {
+    TELEMETRY_FORWARD = 1 << 0,         // Current direction
+    TELEMETRY_TARGET_FORWARD = 1 << 1,
+    TELEMETRY_ENABLED = 1 << 2,         // Enable switch
+    TELEMETRY_ACTIVE = 1 << 3,          // Enabled and no emergency stop
+    TELEMETRY_FIRING = 1 << 4,
+    TELEMETRY_EMERGENCY_STOP = 1 << 5,
+};
+
+struct __attribute__((packed)) TelemetryFrame {
+    uint8_t version;            // TELEMETRY_FRAME_VERSION
+    uint8_t flags;              // TelemetryFlags
+    uint16_t seq;               // +1 per change of the fields below (wraps)
+    uint32_t timestampMs;       // millis() of the state change
+    uint16_t currentSpeed;      // 0.1 %
+    uint16_t targetSpeed;       // 0.1 %
+    uint16_t velocity;          // 0.01 relative units
+};
+
+static_assert(sizeof(TelemetryFrame) == 14, "TelemetryFrame layout changed");
+
+// Which frame fields a subscriber cares about
+enum TelemetryField : uint8_t {
+    TELEMETRY_FIELD_CURRENT_SPEED = 1 << 0,
+    TELEMETRY_FIELD_TARGET_SPEED = 1 << 1,
+    TELEMETRY_FIELD_VELOCITY = 1 << 2,
+    TELEMETRY_FIELD_FLAGS = 1 << 3,         // Direction, enabled, firing, emergency stop
+    TELEMETRY_FIELD_ALL = 0x0F,
+};
+
+// How often and on which changes a subscriber is pushed a frame
+struct TelemetrySubscription {
+    uint16_t minIntervalMs;     // Max rate; changes in between are sent when it expires
+    uint16_t heartbeatMs;       // Resend an unchanged frame this often (0 = never)
+    uint16_t speedDeadband;     // Ignore current-speed moves smaller than this (0.1 %)
+    uint16_t velocityDeadband;  // Same for velocity (0.01 units)
+    uint8_t fieldMask;          // TelemetryField bits that trigger a push
+};
+
+// Called on the comms task with the newest frame
+typedef void (*TelemetryCallback)(const TelemetryFrame& frame, void* context);
+
+// Encode the published state if it changed (control task, after publishRocketState)
+void updateTelemetry();
+
+// Latest frame (any task)
+TelemetryFrame getTelemetryFrame();
+
+// Register a subscriber (any task). Returns its id, or -1 if all
+// TELEMETRY_MAX_SUBSCRIBERS slots are taken. The first frame is pushed at once.
+int subscribeTelemetry(const char* name, const TelemetrySubscription& subscription,
+                       TelemetryCallback callback, void* context = nullptr);
+void unsubscribeTelemetry(int id);
+
+// Push the current frame to one subscriber on the next dispatch (e.g. a '?' query)
+void requestTelemetry(int id);
+
+// Push frames to subscribers whose filters pass (comms task, once per tick).
+// Returns immediately unless the frame changed or a deadline is due.
+void dispatchTelemetry();
+
+// Human-readable status from a frame, integer formatting only. Returns the length.
+size_t formatTelemetryText(const TelemetryFrame& frame, char* buffer, size_t size);
+
+#endif // TELEMETRY_H
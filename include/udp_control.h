@@ -0,0 +1,85 @@
+#ifndef UDP_CONTROL_H
+#define UDP_CONTROL_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Binary control channel on UDP_CONTROL_PORT. All fields are little-endian.
+// Clients send their complete setpoint at least every 100 ms (the repeat is
+// the heartbeat); each datagram carries a new sequence number, so a lost one
+// is simply replaced by the next. The device answers with state datagrams at
+// UDP_STATE_INTERVAL_MS. A client that falls silent for UDP_CONTROL_TIMEOUT_MS
+// while commanding speed or thrust gets a failsafe stop.
+#define UDP_PACKET_MAGIC 0x5453         // "ST"
+#define UDP_PACKET_VERSION 1
+
+enum UdpPacketType : uint8_t {
+    UDP_PACKET_SETPOINT = 1,
+    UDP_PACKET_STATE = 2,
+};
+
+enum UdpSetpointFlags : uint8_t {
+    UDP_SETPOINT_FORWARD = 1 << 0,
+    UDP_SETPOINT_FIRE = 1 << 1,
+};
+
+enum UdpStateFlags : uint8_t {
+    UDP_STATE_FORWARD = 1 << 0,
+    UDP_STATE_TARGET_FORWARD = 1 << 1,
+    UDP_STATE_ENABLED = 1 << 2,
+    UDP_STATE_FIRING = 1 << 3,
+    UDP_STATE_EMERGENCY_STOP = 1 << 4,
+};
+
+// Client -> device (20 bytes)
+struct __attribute__((packed)) UdpSetpointPacket {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;               // UDP_PACKET_SETPOINT
+    uint32_t clientId;
+    uint32_t seq;
+    uint32_t clientTimeMs;
+    uint16_t speedTenths;       // Target speed in 0.1 % (0-1000)
+    uint8_t flags;              // UdpSetpointFlags
+    uint8_t reserved;
+};
+
+// Device -> client (32 bytes)
+struct __attribute__((packed)) UdpStatePacket {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;               // UDP_PACKET_STATE
+    uint32_t ackSeq;            // Newest setpoint seq accepted from this client
+    uint32_t echoTimeMs;        // Its clientTimeMs, for round-trip measurement
+    uint16_t echoAgeMs;         // Time since it arrived (subtract from the RTT)
+    uint16_t reserved;
+    uint32_t stateVersion;
+    uint32_t uptimeMs;
+    uint16_t currentSpeedTenths;
+    uint16_t targetSpeedTenths;
+    uint8_t flags;              // UdpStateFlags
+    uint8_t reserved2[3];
+};
+
+static_assert(sizeof(UdpSetpointPacket) == 20, "UdpSetpointPacket layout changed");
+static_assert(sizeof(UdpStatePacket) == 32, "UdpStatePacket layout changed");
+
+struct UdpControlStats {
+    uint32_t received;          // Valid setpoint datagrams
+    uint32_t malformed;         // Wrong size, magic, version or type
+    uint32_t stale;             // Out of order (older sequence)
+    uint32_t sent;              // State datagrams
+    uint32_t failsafes;         // Stops issued for silent clients
+    uint32_t refused;           // From new clients while every slot was engaged
+    uint8_t clients;
+};
+
+// Start listening (once STA is connected)
+void initUdpControl();
+
+// Network task: send state datagrams and expire silent clients
+void updateUdpControl();
+
+UdpControlStats getUdpControlStats();
+
+#endif // UDP_CONTROL_H
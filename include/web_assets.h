@@ -0,0 +1,20 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A static UI file, gzipped into flash by tools/embed_web_assets.py
+struct WebAsset {
+    const char* path;           // URL it is served at
+    const char* contentType;
+    const char* cacheControl;
+    const char* etag;           // Quoted content hash
+    const uint8_t* data;        // Gzip stream (served as-is)
+    size_t length;
+};
+
+int getWebAssetCount();
+const WebAsset& getWebAsset(int index);
+
+#endif // WEB_ASSETS_H
@@ -2,7 +2,6 @@
 #define WEB_INTERFACE_H
 
 void initWebInterface();
-void initConfigPortalWebInterface();
 void handleWebInterface();
 
 #endif // WEB_INTERFACE_H
@@ -32,16 +32,45 @@ typedef void (*WiFiConnectedCallback)();
 #define OTA_PORT 3232
 #endif
 
+// WiFi is driven by WiFi.onEvent callbacks and a timer-based state machine in
+// handleWiFiLoop(); nothing in here blocks or restarts the device.
+enum WiFiState : uint8_t {
+    WIFI_STATE_OFF,             // Not started (radio profile without WiFi)
+    WIFI_STATE_PORTAL,          // No credentials: setup access point only
+    WIFI_STATE_CONNECTING,      // Association and DHCP in progress
+    WIFI_STATE_CONNECTED,       // Station has an IP address
+    WIFI_STATE_BACKOFF,         // Waiting before the next attempt
+};
+
+struct WiFiStats {
+    WiFiState state;
+    bool apActive;              // Setup access point up (alone or next to the station)
+    uint8_t apStations;
+    uint8_t lastDisconnectReason;   // wifi_err_reason_t
+    uint32_t attempts;
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t backoffMs;         // Current retry delay
+    uint32_t lastStepUs;        // Time spent in handleWiFiLoop() (network task)
+    uint32_t maxStepUs;
+    bool fastConnect;           // Last connection used the cached BSSID and channel
+    uint32_t fastConnectFailures;   // Directed attempts that fell back to a full scan
+    uint32_t bootConnectedMs;   // millis() at the first IP address (0 = not yet)
+    uint32_t bootWebReadyMs;    // millis() once web control is up on the station network
+};
+
 void initWiFi(WiFiConnectedCallback onConnected = nullptr);
 void initOTA();
-void startOTA();
-void stopOTA();
-bool connectToWiFi();
+
+// Persist credentials and connect with them at once, keeping the setup
+// access point up until the station has joined (any task)
 void saveWiFiCredentials(const String& ssid, const String& password);
-bool startConfigPortalSafe();
+
+// State machine step (network task)
 void handleWiFiLoop();
 
-extern bool isConfigMode;
+WiFiStats getWiFiStats();
+const char* getWiFiStateName(WiFiState state);
 
 #endif // WIFI_MANAGER_H
 
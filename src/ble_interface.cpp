@@ -1,7 +1,11 @@
 #include "ble_interface.h"
 #include "config.h"
 #include "rocket_state.h"
+#include "telemetry.h"
+#include "command_parser.h"
+#include "command_bus.h"
 #include "logging.h"
+#include "radio_profile.h"
 
 // ============================================================================
 // TRUE BLE (Bluetooth Low Energy) IMPLEMENTATION
@@ -9,118 +13,365 @@
 // ============================================================================
 
 #include <NimBLEDevice.h>
+#include <atomic>
 
 static NimBLEServer* pServer = nullptr;
 static NimBLECharacteristic* pCommandChar = nullptr;
 static NimBLECharacteristic* pStatusChar = nullptr;
-static bool bleDeviceConnected = false;
-static bool oldBleDeviceConnected = false;
-static unsigned long lastStatusNotify = 0;
+static std::atomic<bool> restartAdvertising(false);
 
-// Process a single command character or command string
-void processBLECommand(const std::string& cmd) {
-    if (cmd.empty()) return;
-    
-    char c = cmd[0];
-    
-    switch (c) {
-        case '+': {
-            float newSpeed = getTargetSpeedPercent() + SPEED_INCREMENT;
-            if (newSpeed > MAX_MOTOR_SPEED) newSpeed = MAX_MOTOR_SPEED;
-            updateTargetSpeed(newSpeed);
-            Logger.printf("BLE: Speed +10%% → %.1f%%\n", newSpeed);
-            break;
-        }
-        case '-': {
-            float newSpeed = getTargetSpeedPercent() - SPEED_INCREMENT;
-            if (newSpeed < 0.0f) newSpeed = 0.0f;
-            updateTargetSpeed(newSpeed);
-            Logger.printf("BLE: Speed -10%% → %.1f%%\n", newSpeed);
-            break;
+// Per connected central: telemetry subscription, connection-parameter mode,
+// notify backpressure and command-to-notify latency
+struct BleConnection {
+    bool used;
+    uint16_t connHandle;
+    int subscriberId;
+    bool activeParams;          // Short connection interval requested
+    uint32_t lastCommandMs;
+    uint32_t commandUs;         // Binary write being timed to its ack (0 = none)
+    uint16_t commandSeq;        // Its seq
+    bool congested;             // Last notify failed for lack of buffers
+    uint32_t congestedAtMs;
+    uint32_t clientId;          // Setpoint client id for binary writes
+    bool hasSeq;
+    uint16_t lastSeq;           // Newest accepted binary write
+    uint32_t lastSeq32;         // ... extended past the 16-bit wrap for the command bus
+    bool awaitingApply;         // Accepted write not yet applied by the control task
+    bool awaitingBusy;
+    uint16_t awaitingSeq;
+    uint32_t awaitingSeq32;
+    uint16_t ackSeq;            // Reported in status notifications
+    uint8_t ackStatus;          // BleAckStatus
+    bool ackUnsent;
+    BleConnectionStats stats;
+};
+
+// Written by the NimBLE host task (connect, write) and the comms task (notify, idle)
+static portMUX_TYPE bleMux = portMUX_INITIALIZER_UNLOCKED;
+static BleConnection bleConnections[CONFIG_BT_NIMBLE_MAX_CONNECTIONS];
+// Applied-seq record of each connection slot, filled in by the control task
+// (guarded by the command bus, reset on connect)
+static SetpointAck bleAcks[CONFIG_BT_NIMBLE_MAX_CONNECTIONS];
+static int writingSubscriberId = -1;    // Subscriber of the central whose write is being parsed (host task)
+static bool notifyFailed = false;       // Set by onStatus during notify() (comms task)
+static uint16_t nextClientId = 0;
+
+// bleMux held
+static BleConnection* findBleConnection(uint16_t connHandle) {
+    for (int i = 0; i < CONFIG_BT_NIMBLE_MAX_CONNECTIONS; i++) {
+        if (bleConnections[i].used && bleConnections[i].connHandle == connHandle) {
+            return &bleConnections[i];
         }
-        case 'S': case 's': {
-            // Speed command: S50 = set speed to 50%
-            if (cmd.length() > 1) {
-                float speed = atof(cmd.c_str() + 1);
-                speed = constrain(speed, 0.0f, MAX_MOTOR_SPEED);
-                updateTargetSpeed(speed);
-                Logger.printf("BLE: Speed set to %.1f%%\n", speed);
+    }
+    return nullptr;
+}
+
+static void requestConnParams(uint16_t connHandle, bool active) {
+    if (active) {
+        pServer->updateConnParams(connHandle, BLE_ACTIVE_MIN_INTERVAL, BLE_ACTIVE_MAX_INTERVAL, 0,
+            BLE_SUPERVISION_TIMEOUT);
+    } else {
+        pServer->updateConnParams(connHandle, BLE_IDLE_MIN_INTERVAL, BLE_IDLE_MAX_INTERVAL,
+            BLE_IDLE_SLAVE_LATENCY, BLE_SUPERVISION_TIMEOUT);
+    }
+}
+
+// Telemetry hub (comms task): notify this central only, with its ack
+static void onBleTelemetry(const TelemetryFrame& frame, void* context) {
+    uint16_t connHandle = (uint16_t)(uintptr_t)context;
+    BleStatusNotification notification;
+    notification.frame = frame;
+    bool ackUnsent = false;
+
+    portENTER_CRITICAL(&bleMux);
+    BleConnection* connection = findBleConnection(connHandle);
+    bool skip = !connection || connection->congested;
+    if (connection) {
+        if (connection->congested) connection->stats.notifySkipped++;
+        notification.ackSeq = connection->ackSeq;
+        notification.ackStatus = connection->ackStatus;
+        ackUnsent = connection->ackUnsent;
+    }
+    portEXIT_CRITICAL(&bleMux);
+    if (skip) return;   // Retried with the newest frame once the buffers drain
+
+    notifyFailed = false;
+    pStatusChar->setValue((const uint8_t*)&notification, sizeof(notification));
+    pStatusChar->notify((const uint8_t*)&notification, sizeof(notification), true, connHandle);
+    uint32_t nowUs = micros();
+
+    portENTER_CRITICAL(&bleMux);
+    connection = findBleConnection(connHandle);
+    if (connection) {
+        BleConnectionStats& stats = connection->stats;
+        if (notifyFailed) {
+            connection->congested = true;
+            connection->congestedAtMs = millis();
+            stats.notifyFailures++;
+        } else {
+            stats.notifies++;
+            bool acked = ackUnsent && connection->ackSeq == notification.ackSeq;
+            if (acked) connection->ackUnsent = false;
+            // Timed write applied: this ack is for it, or for a newer write that superseded it
+            if (connection->commandUs != 0 && acked &&
+                (notification.ackStatus == BLE_ACK_APPLIED || notification.ackStatus == BLE_ACK_BUSY) &&
+                (int16_t)(notification.ackSeq - connection->commandSeq) >= 0) {
+                uint32_t latencyUs = nowUs - connection->commandUs;
+                connection->commandUs = 0;
+                stats.lastLatencyUs = latencyUs;
+                if (latencyUs > stats.maxLatencyUs) stats.maxLatencyUs = latencyUs;
+                stats.avgLatencyUs = (stats.latencySamples == 0) ? latencyUs : (stats.avgLatencyUs * 7 + latencyUs) / 8;
+                stats.latencySamples++;
             }
-            break;
         }
-        case 'R': case 'r': {
-            updateTargetDirection(false);
-            Logger.println("BLE: Direction → REVERSE");
-            break;
+    }
+    portEXIT_CRITICAL(&bleMux);
+}
+
+// Commands from BLE writes go through the shared parser (NimBLE host task only)
+static void handleBLECommand(const ParsedCommand& cmd, void* context) {
+    if (cmd.op == '?') {
+        // Status query - notify the asking central on the next dispatch
+        requestTelemetry(writingSubscriberId);
+    } else {
+        postParsedCommand(cmd, SOURCE_BLE);
+    }
+}
+
+static CommandParser bleParser(handleBLECommand);
+
+// One binary write, validated before anything is posted
+struct BleCommandBatch {
+    uint16_t seq;
+    uint8_t fields;             // SetpointField
+    float speed;
+    bool forward;
+    bool fire;
+    bool status;
+    uint8_t count;
+    CommandType types[BLE_COMMAND_MAX_OPS];
+    float values[BLE_COMMAND_MAX_OPS];
+};
+
+static bool parseBinaryCommand(const uint8_t* data, size_t length, BleCommandBatch& batch) {
+    batch = {};
+    if (length < 3) return false;
+    batch.seq = data[1] | (data[2] << 8);
+
+    size_t pos = 3;
+    while (pos < length) {
+        uint8_t op = data[pos++];
+        size_t argLength;
+        switch (op) {
+            case BLE_OP_SET_SPEED:
+            case BLE_OP_ADJUST_SPEED:
+                argLength = 2;
+                break;
+            case BLE_OP_DIRECTION:
+            case BLE_OP_FIRE:
+                argLength = 1;
+                break;
+            case BLE_OP_EMERGENCY_STOP:
+            case BLE_OP_CLEAR_EMERGENCY_STOP:
+            case BLE_OP_STATUS:
+                argLength = 0;
+                break;
+            default:
+                return false;
         }
-        case 'D': case 'd': {
-            updateTargetDirection(true);
-            Logger.println("BLE: Direction → FORWARD");
-            break;
+        if (pos + argLength > length) return false;
+        uint16_t arg16 = (argLength == 2) ? (data[pos] | (data[pos + 1] << 8)) : 0;
+        uint8_t arg8 = (argLength == 1) ? data[pos] : 0;
+        pos += argLength;
+
+        if (op == BLE_OP_SET_SPEED) {
+            if (arg16 > 1000) return false;
+            batch.fields |= SETPOINT_SPEED;
+            batch.speed = arg16 / 10.0f;
+        } else if (op == BLE_OP_DIRECTION) {
+            batch.fields |= SETPOINT_DIRECTION;
+            batch.forward = arg8 != 0;
+        } else if (op == BLE_OP_FIRE) {
+            batch.fields |= SETPOINT_FIRE;
+            batch.fire = arg8 != 0;
+        } else if (op == BLE_OP_STATUS) {
+            batch.status = true;
+        } else {
+            if (batch.count == BLE_COMMAND_MAX_OPS) return false;
+            CommandType type = (op == BLE_OP_ADJUST_SPEED) ? CMD_ADJUST_SPEED :
+                               (op == BLE_OP_EMERGENCY_STOP) ? CMD_EMERGENCY_STOP : CMD_CLEAR_EMERGENCY_STOP;
+            batch.types[batch.count] = type;
+            batch.values[batch.count++] = (int16_t)arg16 / 10.0f;
         }
-        case 'F': {
-            if (isEnabled() && !isEmergencyStop()) {
-                setFiringThrusters(true);
-                Logger.println("BLE: 🔥 THRUSTERS FIRING!");
+    }
+    return true;
+}
+
+// Binary write (NimBLE host task). Queued opcodes are posted in order, then
+// speed/direction/fire as one numbered setpoint; the ack follows once the
+// control task has applied it (see updateBLEInterface).
+static void handleBinaryCommand(uint16_t connHandle, const uint8_t* data, size_t length, uint32_t writeUs) {
+    BleCommandBatch batch;
+    bool valid = parseBinaryCommand(data, length, batch);
+    uint8_t status = BLE_ACK_NONE;
+    uint32_t seq32 = 0;
+    uint32_t clientId = 0;
+    SetpointAck* ack = nullptr;
+    int subscriberId = -1;
+
+    portENTER_CRITICAL(&bleMux);
+    BleConnection* connection = findBleConnection(connHandle);
+    if (connection) {
+        connection->stats.binaryCommands++;
+        if (!valid) {
+            status = BLE_ACK_REJECTED;
+        } else if (connection->hasSeq && (int16_t)(batch.seq - connection->lastSeq) <= 0) {
+            status = BLE_ACK_STALE;
+        } else {
+            seq32 = connection->hasSeq ? connection->lastSeq32 + (uint16_t)(batch.seq - connection->lastSeq) : batch.seq;
+            connection->hasSeq = true;
+            connection->lastSeq = batch.seq;
+            connection->lastSeq32 = seq32;
+            if (connection->commandUs == 0) {
+                connection->commandUs = writeUs;
+                connection->commandSeq = batch.seq;
             }
-            break;
         }
-        case 'f': {
-            setFiringThrusters(false);
-            Logger.println("BLE: Thrusters stopped");
-            break;
+        if (status != BLE_ACK_NONE) {
+            connection->stats.rejectedCommands++;
+            connection->ackSeq = batch.seq;
+            connection->ackStatus = status;
+            connection->ackUnsent = true;
         }
-        case 'X': case 'x': {
-            setEmergencyStop(true);
-            Logger.println("BLE: 🛑 EMERGENCY STOP!");
-            break;
-        }
-        case 'C': case 'c': {
-            // Clear emergency stop
-            setEmergencyStop(false);
-            Logger.println("BLE: Emergency stop cleared");
-            break;
-        }
-        case '?': {
-            // Status query - will be sent via notification
-            Logger.println("BLE: Status requested");
-            break;
-        }
-        default:
-            break;
+        clientId = connection->clientId;
+        ack = &bleAcks[connection - bleConnections];
+        subscriberId = connection->subscriberId;
     }
+    portEXIT_CRITICAL(&bleMux);
+    if (!connection) return;
+
+    if (status != BLE_ACK_NONE) {
+        LOG_DEBUG("📱 BLE write %u %s", batch.seq, status == BLE_ACK_STALE ? "out of order" : "rejected");
+        requestTelemetry(subscriberId);
+        return;
+    }
+
+    bool busy = false;
+    for (int i = 0; i < batch.count; i++) {
+        if (!postCommand(batch.types[i], SOURCE_BLE, batch.values[i])) busy = true;
+    }
+    // Posted even without fields: it carries the ack through the control task
+    postSetpoint({ clientId, seq32, (uint32_t)millis(), batch.fields, batch.speed, batch.forward, batch.fire }, SOURCE_BLE, ack);
+    if (batch.status) requestTelemetry(subscriberId);
+
+    portENTER_CRITICAL(&bleMux);
+    connection = findBleConnection(connHandle);
+    if (connection) {
+        connection->awaitingBusy = (connection->awaitingApply && connection->awaitingBusy) || busy;
+        connection->awaitingApply = true;
+        connection->awaitingSeq = batch.seq;
+        connection->awaitingSeq32 = seq32;
+    }
+    portEXIT_CRITICAL(&bleMux);
 }
 
 // BLE Server callbacks
 class ServerCallbacks : public NimBLEServerCallbacks {
-    void onConnect(NimBLEServer* pServer) {
-        bleDeviceConnected = true;
-        Logger.println("📱 BLE client connected");
+    void onConnect(NimBLEServer* pServer, ble_gap_conn_desc* desc) {
+        int subscriberId = subscribeTelemetry("ble", { BLE_TELEMETRY_MIN_INTERVAL_MS,
+            BLE_TELEMETRY_HEARTBEAT_MS, BLE_TELEMETRY_SPEED_DEADBAND, 1, TELEMETRY_FIELD_ALL },
+            onBleTelemetry, (void*)(uintptr_t)desc->conn_handle);
+
+        portENTER_CRITICAL(&bleMux);
+        for (int i = 0; i < CONFIG_BT_NIMBLE_MAX_CONNECTIONS; i++) {
+            BleConnection& connection = bleConnections[i];
+            if (connection.used) continue;
+            connection = {};
+            connection.used = true;
+            connection.connHandle = desc->conn_handle;
+            connection.subscriberId = subscriberId;
+            connection.clientId = BLE_SETPOINT_CLIENT_ID | nextClientId++;
+            connection.stats.connHandle = desc->conn_handle;
+            resetSetpointAck(bleAcks[i], connection.clientId);
+            break;
+        }
+        portEXIT_CRITICAL(&bleMux);
+
+        // Idle parameters until the central starts sending commands
+        requestConnParams(desc->conn_handle, false);
+        LOG_INFO("📱 BLE client connected (%d connected)", pServer->getConnectedCount());
+        // Keep advertising so further centrals can connect
+        restartAdvertising.store(true);
     }
 
-    void onDisconnect(NimBLEServer* pServer) {
-        bleDeviceConnected = false;
-        Logger.println("📱 BLE client disconnected");
-        // Restart advertising
-        NimBLEDevice::startAdvertising();
+    void onDisconnect(NimBLEServer* pServer, ble_gap_conn_desc* desc) {
+        int subscriberId = -1;
+        portENTER_CRITICAL(&bleMux);
+        BleConnection* connection = findBleConnection(desc->conn_handle);
+        if (connection) {
+            subscriberId = connection->subscriberId;
+            connection->used = false;
+        }
+        portEXIT_CRITICAL(&bleMux);
+
+        unsubscribeTelemetry(subscriberId);
+        LOG_INFO("📱 BLE client disconnected");
+        restartAdvertising.store(true);
+    }
+
+    void onMTUChange(uint16_t mtu, ble_gap_conn_desc* desc) {
+        LOG_DEBUG("📱 BLE MTU %u (connection %u)", mtu, desc->conn_handle);
     }
 };
 
 // Command characteristic callbacks
 class CommandCallbacks : public NimBLECharacteristicCallbacks {
-    void onWrite(NimBLECharacteristic* pCharacteristic) {
-        std::string value = pCharacteristic->getValue();
-        if (value.length() > 0) {
-            processBLECommand(value);
+    void onWrite(NimBLECharacteristic* pCharacteristic, ble_gap_conn_desc* desc) {
+        uint32_t writeUs = micros();
+        bool wasActive = true;
+        portENTER_CRITICAL(&bleMux);
+        BleConnection* connection = findBleConnection(desc->conn_handle);
+        writingSubscriberId = connection ? connection->subscriberId : -1;
+        if (connection) {
+            wasActive = connection->activeParams;
+            connection->activeParams = true;
+            connection->lastCommandMs = millis();
+            connection->stats.commands++;
+        }
+        portEXIT_CRITICAL(&bleMux);
+
+        // The central is driving: ask for the short connection interval
+        if (!wasActive) {
+            requestConnParams(desc->conn_handle, true);
+        }
+
+        // Each write is a complete batch: binary opcodes or text (e.g. "S50;D;F")
+        NimBLEAttValue value = pCharacteristic->getValue();
+        if (value.length() > 0 && value.data()[0] == BLE_COMMAND_VERSION) {
+            handleBinaryCommand(desc->conn_handle, value.data(), value.length(), writeUs);
+        } else {
+            bleParser.feed((const char*)value.data(), value.length());
+            bleParser.flush();
+        }
+    }
+};
+
+// Status characteristic callbacks. notify() reports its result synchronously,
+// on the task that called it (the comms task, via the telemetry hub).
+class StatusCallbacks : public NimBLECharacteristicCallbacks {
+    void onStatus(NimBLECharacteristic* pCharacteristic, Status status, int code) {
+        if (status == Status::ERROR_GATT) {
+            notifyFailed = true;    // Typically BLE_HS_ENOMEM: no mbufs for the notification
         }
     }
 };
 
 void initBLEInterface() {
-    Logger.println("🔵 Initializing BLE (NimBLE)...");
+    LOG_INFO("🔵 Initializing BLE (NimBLE)...");
     
     // Initialize NimBLE
     NimBLEDevice::init(BLE_DEVICE_NAME);
+    NimBLEDevice::setMTU(BLE_MTU);
     
     // Set power level for better range
     NimBLEDevice::setPower(ESP_PWR_LVL_P9);
@@ -144,6 +395,7 @@ void initBLEInterface() {
         BLE_STATUS_CHAR_UUID,
         NIMBLE_PROPERTY::READ | NIMBLE_PROPERTY::NOTIFY
     );
+    pStatusChar->setCallbacks(new StatusCallbacks());
     
     // Start service
     pService->start();
@@ -156,46 +408,90 @@ void initBLEInterface() {
     pAdvertising->setMaxPreferred(0x12);
     NimBLEDevice::startAdvertising();
     
-    Logger.printf("✅ BLE initialized as '%s'\n", BLE_DEVICE_NAME);
-    Logger.println("   Service UUID: " BLE_SERVICE_UUID);
+    LOG_INFO("✅ BLE initialized as '%s'", BLE_DEVICE_NAME);
+    LOG_DEBUG("   Service UUID: " BLE_SERVICE_UUID);
 }
 
+// Status notifications are pushed per central by the telemetry hub (binary
+// TelemetryFrame, see telemetry.h). This restarts advertising, relaxes the
+// connection interval of centrals that stopped driving and retries notifies
+// that failed for lack of buffers.
 void updateBLEInterface() {
-    // Handle connection state changes
-    if (bleDeviceConnected && !oldBleDeviceConnected) {
-        // Just connected - send initial status
-        lastStatusNotify = 0;
-    }
-    
-    if (!bleDeviceConnected && oldBleDeviceConnected) {
-        // Just disconnected
+    if (!pServer) return;
+
+    if (restartAdvertising.exchange(false) &&
+        pServer->getConnectedCount() < CONFIG_BT_NIMBLE_MAX_CONNECTIONS) {
+        NimBLEDevice::startAdvertising();
     }
-    
-    oldBleDeviceConnected = bleDeviceConnected;
-    
-    // Send status notifications periodically
-    if (bleDeviceConnected && pStatusChar) {
-        unsigned long now = millis();
-        if (now - lastStatusNotify >= BLE_STATUS_NOTIFY_INTERVAL_MS) {
-            // Format: "S:50.0,T:60.0,D:1,E:1,F:0"
-            char status[64];
-            snprintf(status, sizeof(status), 
-                "S:%.1f,T:%.1f,D:%d,E:%d,F:%d",
-                getCurrentSpeedPercent(),
-                getTargetSpeedPercent(),
-                getCurrentDirection() ? 1 : 0,
-                isEnabled() ? 1 : 0,
-                isFiringThrusters() ? 1 : 0
-            );
-            
-            pStatusChar->setValue(status);
-            pStatusChar->notify();
-            
-            lastStatusNotify = now;
+
+    uint32_t now = millis();
+    for (int i = 0; i < CONFIG_BT_NIMBLE_MAX_CONNECTIONS; i++) {
+        bool goIdle = false, retry = false, awaiting;
+        uint16_t connHandle;
+        int subscriberId;
+        uint32_t awaitingSeq32;
+
+        portENTER_CRITICAL(&bleMux);
+        BleConnection& connection = bleConnections[i];
+        connHandle = connection.connHandle;
+        subscriberId = connection.subscriberId;
+        awaiting = connection.used && connection.awaitingApply;
+        awaitingSeq32 = connection.awaitingSeq32;
+        if (connection.used) {
+            if (connection.activeParams && now - connection.lastCommandMs > BLE_IDLE_AFTER_MS) {
+                connection.activeParams = false;
+                goIdle = true;
+            }
+            if (connection.congested && now - connection.congestedAtMs >= BLE_NOTIFY_RETRY_MS) {
+                connection.congested = false;
+                retry = true;
+            }
+        }
+        portEXIT_CRITICAL(&bleMux);
+
+        // Acknowledge the newest binary write once the control task has applied it
+        uint32_t appliedSeq;
+        if (awaiting && getSetpointAck(bleAcks[i], appliedSeq) && (int32_t)(appliedSeq - awaitingSeq32) >= 0) {
+            portENTER_CRITICAL(&bleMux);
+            if (connection.used && connection.awaitingApply && connection.awaitingSeq32 == awaitingSeq32) {
+                connection.awaitingApply = false;
+                connection.ackSeq = connection.awaitingSeq;
+                connection.ackStatus = connection.awaitingBusy ? BLE_ACK_BUSY : BLE_ACK_APPLIED;
+                connection.ackUnsent = true;
+            } else {
+                awaiting = false;
+            }
+            portEXIT_CRITICAL(&bleMux);
+            if (awaiting) requestTelemetry(subscriberId);
         }
+
+        if (goIdle) requestConnParams(connHandle, false);
+        if (retry) requestTelemetry(subscriberId);
     }
 }
 
+int getBleConnectionCount() {
+    return CONFIG_BT_NIMBLE_MAX_CONNECTIONS;
+}
+
+bool getBleConnectionStats(int index, BleConnectionStats& out) {
+    if (!pServer || index < 0 || index >= CONFIG_BT_NIMBLE_MAX_CONNECTIONS) return false;
+
+    portENTER_CRITICAL(&bleMux);
+    const BleConnection& connection = bleConnections[index];
+    bool used = connection.used;
+    out = connection.stats;
+    out.activeParams = connection.activeParams;
+    portEXIT_CRITICAL(&bleMux);
+    if (!used) return false;
+
+    NimBLEConnInfo info = pServer->getPeerIDInfo(out.connHandle);
+    out.mtu = info.getMTU();
+    out.interval = info.getConnInterval();
+    out.latency = info.getConnLatency();
+    return true;
+}
+
 
 // ============================================================================
 // BLUETOOTH CLASSIC (SPP) IMPLEMENTATION
@@ -210,93 +506,101 @@ void updateBLEInterface() {
 
 static BluetoothSerial SerialBT;
 static bool btClassicInitialized = false;
+static unsigned long lastSppInput = 0;
+
+static void handleSppCommand(const ParsedCommand& cmd, void* context) {
+    switch (cmd.op) {
+        case '?': {
+            char status[128];
+            formatTelemetryText(getTelemetryFrame(), status, sizeof(status));
+            SerialBT.println(status);
+            return;
+        }
+        case 'F':
+            if (!getRocketStateSnapshot().isActive()) {
+                SerialBT.println("Cannot fire - system disabled");
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    
+    // Echoes use the telemetry line's wording and integer tenths, in plain ASCII
+    // so every terminal app shows them (no float printf on the comms task)
+    if (postParsedCommand(cmd, SOURCE_SPP)) {
+        switch (cmd.op) {
+            case '+': SerialBT.println("Speed +10%"); break;
+            case '-': SerialBT.println("Speed -10%"); break;
+            case 'S': {
+                uint16_t tenths = (uint16_t)lroundf(constrain(cmd.value, 0.0f, MAX_MOTOR_SPEED) * 10.0f);
+                SerialBT.printf("Speed: %u.%u%% (target)\n", tenths / 10, tenths % 10);
+                break;
+            }
+            case 'D': SerialBT.println("Dir: FWD (target)"); break;
+            case 'R': SerialBT.println("Dir: REV (target)"); break;
+            case 'F': SerialBT.println("Firing: YES"); break;
+            case 'f': SerialBT.println("Firing: NO"); break;
+            case 'X': SerialBT.println("EMERGENCY STOP"); break;
+            case 'C': SerialBT.println("Emergency stop cleared"); break;
+            case 'L': SerialBT.printf("Log level: %s\n", Logger.getLevelName(Logger.getLevel())); break;
+            case 'P': SerialBT.printf("Radio profile: %s, restarting\n", getRadioProfile((int)cmd.value).name); break;
+        }
+    } else if (cmd.op == 'P') {
+        SerialBT.println("Unknown radio profile");
+    } else {
+        SerialBT.println("Command queue full");
+    }
+}
+
+static CommandParser sppParser(handleSppCommand);
+
+// Status line pushed by the telemetry hub while a terminal is connected
+static void onSppTelemetry(const TelemetryFrame& frame, void* context) {
+    if (!SerialBT.hasClient()) return;
+    char status[128];
+    formatTelemetryText(frame, status, sizeof(status));
+    SerialBT.printf("[%lus] %s\n", millis() / 1000, status);
+}
+
+// Mirrors the log to a connected SPP terminal (BluetoothSerial has no availableForWrite)
+class SppLogSink : public PrintSink {
+public:
+    SppLogSink() : PrintSink("spp", SerialBT, SPP_LOG_BACKLOG, false) {}
+    bool isReady() override { return SerialBT.hasClient(); }
+};
+
+static SppLogSink sppLogSink;
 
 void initBluetoothClassic() {
-    Logger.println("🔷 Initializing Bluetooth Classic (SPP)...");
+    LOG_INFO("🔷 Initializing Bluetooth Classic (SPP)...");
     
     if (!SerialBT.begin(BT_CLASSIC_DEVICE_NAME)) {
-        Logger.println("❌ Bluetooth Classic initialization failed!");
+        LOG_ERROR("❌ Bluetooth Classic initialization failed!");
         return;
     }
     
     btClassicInitialized = true;
-    Logger.printf("✅ Bluetooth Classic initialized as '%s'\n", BT_CLASSIC_DEVICE_NAME);
-    Logger.println("   Commands: +, -, D, R, F, X, ? (status)");
+    Logger.addSink(sppLogSink);
+    subscribeTelemetry("spp", { SPP_TELEMETRY_MIN_INTERVAL_MS, SPP_TELEMETRY_HEARTBEAT_MS,
+        TEXT_TELEMETRY_SPEED_DEADBAND, 10, TELEMETRY_FIELD_ALL }, onSppTelemetry);
+    LOG_INFO("✅ Bluetooth Classic initialized as '%s'", BT_CLASSIC_DEVICE_NAME);
+    LOG_DEBUG("   Commands: +, -, S##, D, R, F, f, X, C, L#, P#, ? (status)");
 }
 
 void updateBluetoothClassic() {
     if (!btClassicInitialized) return;
     
-    // Read available BT Classic input
-    while (SerialBT.available()) {
-        char c = SerialBT.read();
-        
-        switch (c) {
-            case '+': {
-                float newSpeed = getTargetSpeedPercent() + SPEED_INCREMENT;
-                if (newSpeed > MAX_MOTOR_SPEED) newSpeed = MAX_MOTOR_SPEED;
-                updateTargetSpeed(newSpeed);
-                SerialBT.printf("Speed → %.1f%%\n", newSpeed);
-                break;
-            }
-            case '-': {
-                float newSpeed = getTargetSpeedPercent() - SPEED_INCREMENT;
-                if (newSpeed < 0.0f) newSpeed = 0.0f;
-                updateTargetSpeed(newSpeed);
-                SerialBT.printf("Speed → %.1f%%\n", newSpeed);
-                break;
-            }
-            case 'R': case 'r': {
-                updateTargetDirection(false);
-                SerialBT.println("Direction → REVERSE");
-                break;
-            }
-            case 'D': case 'd': {
-                updateTargetDirection(true);
-                SerialBT.println("Direction → FORWARD");
-                break;
-            }
-            case 'F': case 'f': {
-                if (isEnabled() && !isEmergencyStop()) {
-                    setFiringThrusters(true);
-                    SerialBT.println("🔥 THRUSTERS FIRING!");
-                } else {
-                    SerialBT.println("Cannot fire - system disabled");
-                }
-                break;
-            }
-            case 'X': case 'x': {
-                setEmergencyStop(true);
-                SerialBT.println("🛑 EMERGENCY STOP!");
-                break;
-            }
-            case '?': {
-                SerialBT.printf("Speed: %.1f%%/%.1f%%, Dir: %s, En: %s, Fire: %s\n",
-                    getTargetSpeedPercent(),
-                    getCurrentSpeedPercent(),
-                    getCurrentDirection() ? "FWD" : "REV",
-                    isEnabled() ? "YES" : "NO",
-                    isFiringThrusters() ? "YES" : "NO"
-                );
-                break;
-            }
-            default:
-                break;
-        }
+    // Feed available BT Classic input to the shared command parser (bounded per tick)
+    int budget = COMMAND_MAX_BYTES_PER_TICK;
+    while (budget-- > 0 && SerialBT.available()) {
+        sppParser.feed((char)SerialBT.read());
+        lastSppInput = millis();
     }
     
-    // Periodic status (every 5 seconds)
-    static unsigned long lastBTStatus = 0;
-    if (millis() - lastBTStatus > 5000) {
-        if (SerialBT.hasClient()) {
-            SerialBT.printf("[%lus] Speed: %.1f%%, Dir: %s, En: %s\n",
-                millis() / 1000,
-                getCurrentSpeedPercent(),
-                getCurrentDirection() ? "FWD" : "REV",
-                isEnabled() ? "YES" : "NO"
-            );
-        }
-        lastBTStatus = millis();
+    // Complete a pending multi-character command (e.g. "S50") if no input for a while
+    if (sppParser.hasPending() && (millis() - lastSppInput) > SERIAL_COMMAND_TIMEOUT_MS) {
+        sppParser.flush();
     }
 }
 
@@ -0,0 +1,356 @@
+#include "command_bus.h"
+#include "config.h"
+#include "rocket_state.h"
+#include "logging.h"
+#include <Arduino.h>
+#include <atomic>
+
+static_assert((COMMAND_QUEUE_SIZE & (COMMAND_QUEUE_SIZE - 1)) == 0, "COMMAND_QUEUE_SIZE must be a power of two");
+
+// Bounded MPSC ring (Vyukov): each slot carries a sequence number that tells
+// producers whether it is free and the consumer whether it is filled.
+struct CommandSlot {
+    std::atomic<uint32_t> sequence;
+    Command command;
+};
+
+static CommandSlot slots[COMMAND_QUEUE_SIZE];
+static std::atomic<uint32_t> enqueuePos(0);
+static uint32_t dequeuePos = 0;                 // Control task only
+
+static std::atomic<uint32_t> postedCount[SOURCE_COUNT];
+static std::atomic<uint32_t> droppedCount(0);
+static CommandBusStats stats;                   // Written by the control task
+static std::atomic<bool> statsResetRequested(false);
+
+// Setpoint mailbox: one pending slot, overwritten by newer setpoints and taken
+// by the control task. Per-client sequence tracking rejects out-of-order updates;
+// each transport has its own client slots, so a burst of web clients can't push
+// a BLE or UDP client out and get its stale updates accepted as a new client's.
+struct SetpointClient {
+    uint32_t id;
+    uint32_t seq;
+    uint32_t clientTimeMs;
+    uint32_t lastSeenMs;
+    bool used;
+};
+
+// Ack records waiting on the mailbox's setpoint: one entry per record, newest seq
+struct PendingAck {
+    SetpointAck* ack;
+    uint32_t clientId;
+    uint32_t seq;
+};
+
+static portMUX_TYPE setpointMux = portMUX_INITIALIZER_UNLOCKED;
+struct SetpointPool {
+    uint8_t first;
+    uint8_t count;
+};
+
+// Panel, serial and SPP don't post setpoints; they share one spare slot
+static const int SETPOINT_CLIENT_SLOTS = SETPOINT_CLIENT_SLOTS_BLE + SETPOINT_CLIENT_SLOTS_WEB + SETPOINT_CLIENT_SLOTS_UDP + 1;
+
+static SetpointPool getSetpointPool(CommandSource source) {
+    switch (source) {
+        case SOURCE_BLE: return { 0, SETPOINT_CLIENT_SLOTS_BLE };
+        case SOURCE_WEB: return { SETPOINT_CLIENT_SLOTS_BLE, SETPOINT_CLIENT_SLOTS_WEB };
+        case SOURCE_UDP: return { SETPOINT_CLIENT_SLOTS_BLE + SETPOINT_CLIENT_SLOTS_WEB, SETPOINT_CLIENT_SLOTS_UDP };
+        default: return { SETPOINT_CLIENT_SLOTS - 1, 1 };
+    }
+}
+
+static SetpointClient setpointClients[SETPOINT_CLIENT_SLOTS];
+static Setpoint pendingSetpoint;
+static CommandSource pendingSetpointSource;
+static bool setpointPending = false;
+static uint32_t pendingSetpointUs = 0;
+static PendingAck pendingAcks[SETPOINT_CLIENT_SLOTS_BLE];
+static int pendingAckCount = 0;
+static uint32_t setpointsAccepted = 0;      // Guarded by setpointMux
+static uint32_t setpointsStale = 0;
+
+static const char* SOURCE_NAMES[SOURCE_COUNT] = { "Panel", "Serial", "BLE", "SPP", "Web", "UDP" };
+
+void initCommandBus() {
+    for (uint32_t i = 0; i < COMMAND_QUEUE_SIZE; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+    memset(setpointClients, 0, sizeof(setpointClients));
+    setpointPending = false;
+    pendingAckCount = 0;
+    resetCommandBusStats();
+    stats = {};
+    statsResetRequested.store(false, std::memory_order_relaxed);
+
+    LOG_INFO("✅ Command bus initialized");
+}
+
+bool postCommand(CommandType type, CommandSource source, float value) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    CommandSlot* slot;
+
+    for (;;) {
+        slot = &slots[pos & (COMMAND_QUEUE_SIZE - 1)];
+        uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Consumer hasn't freed this slot yet - queue is full
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->command.type = type;
+    slot->command.source = source;
+    slot->command.value = value;
+    slot->command.timestampUs = micros();
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    postedCount[source].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Finds the client's slot, or recycles the transport's least recently seen one (setpointMux held)
+static SetpointClient& findSetpointClient(uint32_t id, CommandSource source, uint32_t nowMs) {
+    SetpointPool pool = getSetpointPool(source);
+    SetpointClient* oldest = &setpointClients[pool.first];
+    for (int i = pool.first; i < pool.first + pool.count; i++) {
+        SetpointClient& client = setpointClients[i];
+        if (client.used && client.id == id) {
+            return client;
+        }
+        if (!client.used || (oldest->used && (int32_t)(client.lastSeenMs - oldest->lastSeenMs) < 0)) {
+            oldest = &client;
+        }
+    }
+    oldest->id = id;
+    oldest->used = false;   // New client: accept its first setpoint whatever the numbering
+    oldest->lastSeenMs = nowMs;
+    return *oldest;
+}
+
+// Remember to fill in this record when the mailbox is applied (setpointMux held)
+static void addPendingAck(SetpointAck* ack, uint32_t clientId, uint32_t seq) {
+    int i = 0;
+    while (i < pendingAckCount && pendingAcks[i].ack != ack) i++;
+    if (i == pendingAckCount) {
+        if (pendingAckCount == SETPOINT_CLIENT_SLOTS_BLE) return;  // More records than connections
+        pendingAckCount++;
+    }
+    pendingAcks[i] = { ack, clientId, seq };
+}
+
+SetpointResult postSetpoint(const Setpoint& setpoint, CommandSource source, SetpointAck* ack) {
+    uint32_t nowMs = millis();
+    SetpointResult result = SETPOINT_ACCEPTED;
+    Setpoint setpointCopy = setpoint;
+
+    portENTER_CRITICAL(&setpointMux);
+    SetpointClient& client = findSetpointClient(setpoint.clientId, source, nowMs);
+    // Sequence and client time must both move forward (wrap-safe)
+    if (client.used && ((int32_t)(setpoint.seq - client.seq) <= 0 ||
+                        (int32_t)(setpoint.clientTimeMs - client.clientTimeMs) < 0)) {
+        result = SETPOINT_STALE;
+        setpointsStale++;
+    } else {
+        client.used = true;
+        client.seq = setpoint.seq;
+        client.clientTimeMs = setpoint.clientTimeMs;
+        // Coalesce: newer values win, fields the update leaves out stay pending
+        uint8_t fields = setpoint.fields;
+        if (setpointPending) {
+            fields |= pendingSetpoint.fields;
+            if (!(setpoint.fields & SETPOINT_SPEED)) setpointCopy.speed = pendingSetpoint.speed;
+            if (!(setpoint.fields & SETPOINT_DIRECTION)) setpointCopy.forward = pendingSetpoint.forward;
+            if (!(setpoint.fields & SETPOINT_FIRE)) setpointCopy.fire = pendingSetpoint.fire;
+        } else {
+            pendingSetpointUs = micros();
+        }
+        pendingSetpoint = setpointCopy;
+        pendingSetpoint.fields = fields;
+        pendingSetpointSource = source;
+        setpointPending = true;
+        setpointsAccepted++;
+        if (ack) addPendingAck(ack, setpoint.clientId, setpoint.seq);
+    }
+    client.lastSeenMs = nowMs;
+    portEXIT_CRITICAL(&setpointMux);
+
+    if (result == SETPOINT_ACCEPTED) {
+        postedCount[source].fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+static void applyCommand(const Command& cmd) {
+    const char* source = getCommandSourceName(cmd.source);
+    LOG_FAST(LOG_LEVEL_TRACE, "➡️ %s: command %d value %.1f", source, (int)cmd.type, cmd.value);
+
+    switch (cmd.type) {
+        case CMD_SET_SPEED:
+            updateTargetSpeed(cmd.value);
+            break;
+        case CMD_ADJUST_SPEED:
+            updateTargetSpeed(getTargetSpeedPercent() + cmd.value);
+            break;
+        case CMD_SET_DIRECTION:
+            updateTargetDirection(cmd.value != 0.0f);
+            break;
+        case CMD_TOGGLE_DIRECTION:
+            if (isEnabled()) {
+                updateTargetDirection(!getTargetDirection());
+            }
+            break;
+        case CMD_FIRE:
+            if (cmd.value == 0.0f) {
+                if (isFiringThrusters()) {
+                    setFiringThrusters(false);
+                }
+            } else if (isEnabled() && !isEmergencyStop()) {
+                setFiringThrusters(true);
+            } else {
+                LOG_FAST(LOG_LEVEL_WARN, "⚠️ %s: Cannot fire thrusters - system disabled or emergency stop active", source);
+            }
+            break;
+        case CMD_EMERGENCY_STOP:
+            LOG_FAST(LOG_LEVEL_WARN, "🛑 Emergency stop requested by %s", source);
+            setEmergencyStop(true);
+            break;
+        case CMD_CLEAR_EMERGENCY_STOP:
+            LOG_FAST(LOG_LEVEL_INFO, "Emergency stop clear requested by %s", source);
+            setEmergencyStop(false);
+            break;
+        case CMD_SET_ENABLED:
+            setEnabled(cmd.value != 0.0f);
+            break;
+    }
+}
+
+void processCommands() {
+    uint32_t drained = 0;
+
+    if (statsResetRequested.exchange(false, std::memory_order_acquire)) {
+        stats = {};
+    }
+
+    while (drained < COMMAND_QUEUE_SIZE) {
+        CommandSlot& slot = slots[dequeuePos & (COMMAND_QUEUE_SIZE - 1)];
+        uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (dequeuePos + 1)) < 0) {
+            break; // Empty
+        }
+
+        Command cmd = slot.command;
+        slot.sequence.store(dequeuePos + COMMAND_QUEUE_SIZE, std::memory_order_release);
+        dequeuePos++;
+        drained++;
+
+        applyCommand(cmd);
+
+        uint32_t latencyUs = micros() - cmd.timestampUs;
+        stats.lastLatencyUs = latencyUs;
+        if (latencyUs > stats.maxLatencyUs) stats.maxLatencyUs = latencyUs;
+        stats.avgLatencyUs = (stats.avgLatencyUs == 0) ? latencyUs : (stats.avgLatencyUs * 7 + latencyUs) / 8;
+        stats.applied++;
+    }
+
+    stats.depth = drained;
+    if (drained > stats.maxDepth) stats.maxDepth = drained;
+
+    // Newest setpoint (older ones in the same tick were overwritten in the mailbox)
+    Setpoint setpoint;
+    CommandSource source;
+    uint32_t postedUs;
+    PendingAck acks[SETPOINT_CLIENT_SLOTS_BLE];
+    int ackCount;
+    portENTER_CRITICAL(&setpointMux);
+    bool pending = setpointPending;
+    setpoint = pendingSetpoint;
+    source = pendingSetpointSource;
+    postedUs = pendingSetpointUs;
+    setpointPending = false;
+    // Every client coalesced into this setpoint is acknowledged once it is applied
+    ackCount = pendingAckCount;
+    memcpy(acks, pendingAcks, ackCount * sizeof(PendingAck));
+    pendingAckCount = 0;
+    portEXIT_CRITICAL(&setpointMux);
+    if (!pending) return;
+
+    if (setpoint.fields & SETPOINT_SPEED) {
+        applyCommand({ CMD_SET_SPEED, source, setpoint.speed, postedUs });
+    }
+    if (setpoint.fields & SETPOINT_DIRECTION) {
+        applyCommand({ CMD_SET_DIRECTION, source, setpoint.forward ? 1.0f : 0.0f, postedUs });
+    }
+    if (setpoint.fields & SETPOINT_FIRE) {
+        applyCommand({ CMD_FIRE, source, setpoint.fire ? 1.0f : 0.0f, postedUs });
+    }
+    stats.setpointsApplied++;
+
+    portENTER_CRITICAL(&setpointMux);
+    for (int i = 0; i < ackCount; i++) {
+        // Skip a record rebound to another client while the setpoint was applied
+        SetpointAck& ack = *acks[i].ack;
+        if (ack.clientId == acks[i].clientId) {
+            ack.appliedSeq = acks[i].seq;
+            ack.hasApplied = true;
+        }
+    }
+    portEXIT_CRITICAL(&setpointMux);
+}
+
+void resetSetpointAck(SetpointAck& ack, uint32_t clientId) {
+    portENTER_CRITICAL(&setpointMux);
+    ack.clientId = clientId;
+    ack.appliedSeq = 0;
+    ack.hasApplied = false;
+    portEXIT_CRITICAL(&setpointMux);
+}
+
+bool getSetpointAck(const SetpointAck& ack, uint32_t& seq) {
+    portENTER_CRITICAL(&setpointMux);
+    bool found = ack.hasApplied;
+    seq = ack.appliedSeq;
+    portEXIT_CRITICAL(&setpointMux);
+    return found;
+}
+
+CommandBusStats getCommandBusStats() {
+    CommandBusStats copy = stats;
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        copy.posted[i] = postedCount[i].load(std::memory_order_relaxed);
+    }
+    copy.dropped = droppedCount.load(std::memory_order_relaxed);
+    portENTER_CRITICAL(&setpointMux);
+    copy.setpointsAccepted = setpointsAccepted;
+    copy.setpointsStale = setpointsStale;
+    portEXIT_CRITICAL(&setpointMux);
+    return copy;
+}
+
+void resetCommandBusStats() {
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        postedCount[i].store(0, std::memory_order_relaxed);
+    }
+    droppedCount.store(0, std::memory_order_relaxed);
+    portENTER_CRITICAL(&setpointMux);
+    setpointsAccepted = 0;
+    setpointsStale = 0;
+    portEXIT_CRITICAL(&setpointMux);
+    // The control task owns the rest and clears it on its next tick
+    statsResetRequested.store(true, std::memory_order_release);
+}
+
+const char* getCommandSourceName(CommandSource source) {
+    return (source < SOURCE_COUNT) ? SOURCE_NAMES[source] : "?";
+}
@@ -0,0 +1,156 @@
+#include "command_parser.h"
+#include "config.h"
+#include "logging.h"
+#include "radio_profile.h"
+#include <stdlib.h>
+
+CommandParser::CommandParser(ParsedCommandHandler handler, void* context) :
+    handler(handler),
+    context(context),
+    pendingOp(0),
+    numberLength(0),
+    tokenLength(0),
+    discarding(false),
+    commandCount(0),
+    errorCount(0)
+{
+    number[0] = '\0';
+}
+
+static bool isSeparator(char c) {
+    return c == ';' || c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Malformed token: count it and drop everything up to the next separator,
+// so no part of it is applied
+void CommandParser::reject() {
+    errorCount++;
+    pendingOp = 0;
+    numberLength = 0;
+    tokenLength = 0;
+    discarding = true;
+}
+
+void CommandParser::queue(char op, float value) {
+    if (tokenLength == COMMAND_PARSER_MAX_TOKEN_OPS) {
+        reject();
+        return;
+    }
+    token[tokenLength++] = { op, value };
+}
+
+bool CommandParser::completePending() {
+    if (!pendingOp) return true;
+
+    // S/L/P needs a number, all of which must parse (no "S5.5.5")
+    char* end = nullptr;
+    float value = 0.0f;
+    if (numberLength > 0) {
+        number[numberLength] = '\0';
+        value = strtof(number, &end);
+    }
+    if (numberLength == 0 || end != number + numberLength) {
+        reject();
+        return false;
+    }
+    // Out-of-range log levels are malformed, not clamped ("L300")
+    if (pendingOp == 'L' && value > LOG_LEVEL_TRACE) {
+        reject();
+        return false;
+    }
+
+    char op = pendingOp;
+    pendingOp = 0;
+    numberLength = 0;
+    queue(op, value);
+    return !discarding;
+}
+
+// The token ended well-formed: hand its commands to the handler
+void CommandParser::endToken() {
+    if (!completePending()) return;
+    for (uint8_t i = 0; i < tokenLength; i++) {
+        commandCount++;
+        if (handler) handler(token[i], context);
+    }
+    tokenLength = 0;
+}
+
+void CommandParser::feed(char c) {
+    if (isSeparator(c)) {
+        if (!discarding) endToken();
+        discarding = false;
+        return;
+    }
+    if (discarding) return;
+
+    if (pendingOp) {
+        if ((c >= '0' && c <= '9') || c == '.') {
+            if (numberLength < COMMAND_PARSER_MAX_NUMBER) {
+                number[numberLength++] = c;
+            } else {
+                reject();   // Number too long
+            }
+            return;
+        }
+        // "S50D" ends the number at the next command; "S-5" rejects the token
+        if (!completePending()) return;
+    }
+
+    switch (c) {
+        case '+': case '-': case '?':
+        case 'f':
+        case 'F':
+            queue(c, 0.0f);
+            break;
+        case 'D': case 'd':
+        case 'R': case 'r':
+        case 'X': case 'x':
+        case 'C': case 'c':
+            queue(c & ~0x20, 0.0f); // Upper-case
+            break;
+        case 'S': case 's':
+        case 'L': case 'l':
+        case 'P': case 'p':
+            pendingOp = c & ~0x20;
+            numberLength = 0;
+            break;
+        default:
+            reject();
+            break;
+    }
+}
+
+void CommandParser::feed(const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        feed(data[i]);
+    }
+}
+
+void CommandParser::flush() {
+    if (!discarding) endToken();
+    discarding = false;
+}
+
+bool postParsedCommand(const ParsedCommand& cmd, CommandSource source) {
+    switch (cmd.op) {
+        case '+': return postCommand(CMD_ADJUST_SPEED, source, SPEED_INCREMENT);
+        case '-': return postCommand(CMD_ADJUST_SPEED, source, -SPEED_INCREMENT);
+        case 'S': return postCommand(CMD_SET_SPEED, source, cmd.value);
+        case 'D': return postCommand(CMD_SET_DIRECTION, source, 1.0f);
+        case 'R': return postCommand(CMD_SET_DIRECTION, source, 0.0f);
+        case 'F': return postCommand(CMD_FIRE, source, 1.0f);
+        case 'f': return postCommand(CMD_FIRE, source, 0.0f);
+        case 'X': return postCommand(CMD_EMERGENCY_STOP, source);
+        case 'C': return postCommand(CMD_CLEAR_EMERGENCY_STOP, source);
+        case 'L':
+            // Not a state change - applied directly rather than through the bus
+            Logger.setLevel((uint8_t)cmd.value);
+            LOG_INFO("📝 Log level set to %s by %s", Logger.getLevelName(Logger.getLevel()), getCommandSourceName(source));
+            return true;
+        case 'P':
+            // Persisted, applied by a restart
+            return setRadioProfile((int)cmd.value);
+        default:  return false;
+    }
+}
@@ -0,0 +1,190 @@
+#include "crash_log.h"
+#include "rocket_state.h"
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_rom_crc.h>
+
+#define CRASH_LOG_MAGIC 0x53544C47  // "STLG"
+
+// Everything below lives in RTC slow memory that is not cleared on a reset.
+// Each entry and the state snapshot carry their own CRC, so a reset in the
+// middle of an update only loses that one item.
+struct CrashLogEntry {
+    uint32_t seq;
+    uint32_t timestampMs;
+    uint16_t length;
+    uint16_t reserved;
+    char text[CRASH_LOG_TEXT_LENGTH];
+    uint32_t crc;
+};
+
+struct CrashStateSnapshot {
+    uint32_t uptimeMs;
+    float targetSpeed;
+    float currentSpeed;
+    uint8_t flags;
+    uint8_t reserved[3];
+    uint32_t minFreeHeap;
+    uint32_t crc;
+};
+
+enum CrashStateFlags : uint8_t {
+    STATE_DIRECTION = 1 << 0,
+    STATE_ENABLED = 1 << 1,
+    STATE_FIRING = 1 << 2,
+    STATE_EMERGENCY_STOP = 1 << 3,
+};
+
+struct CrashLogArea {
+    uint32_t magic;
+    uint32_t magicInverted;
+    CrashStateSnapshot state;
+    CrashLogEntry entries[CRASH_LOG_RECORDS];
+};
+
+RTC_NOINIT_ATTR static CrashLogArea rtcArea;
+
+// Recovered copy of the previous session (regular RAM)
+static PreviousSession previous = {};
+static CrashLogEntry previousEntries[CRASH_LOG_RECORDS];
+
+template <typename T>
+static uint32_t itemCrc(const T& item) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&item, offsetof(T, crc));
+}
+
+static const char* resetReasonName(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return "power-on";
+        case ESP_RST_EXT:       return "external reset";
+        case ESP_RST_SW:        return "software restart";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "interrupt watchdog";
+        case ESP_RST_TASK_WDT:  return "task watchdog";
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deep sleep wake";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "SDIO reset";
+        default:                return "unknown";
+    }
+}
+
+// Mirrors the newest records into the RTC ring (runs on the log drain task)
+class RtcLogSink : public LogSink {
+public:
+    RtcLogSink() : LogSink("rtc", CRASH_LOG_RECORDS) {}
+
+    bool writeRecord(const LogRecord& record) override {
+        CrashLogEntry& entry = rtcArea.entries[record.seq % CRASH_LOG_RECORDS];
+        entry.crc = 0;
+        entry.seq = record.seq;
+        entry.timestampMs = record.timestampMs;
+        entry.length = min<uint16_t>(record.length, CRASH_LOG_TEXT_LENGTH);
+        entry.reserved = 0;
+        memcpy(entry.text, record.text, entry.length);
+        entry.crc = itemCrc(entry);
+        return true;
+    }
+};
+
+static RtcLogSink rtcLogSink;
+
+static void recoverPreviousSession() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    previous.resetReason = resetReasonName(reason);
+
+    // RTC memory is undefined after power-on
+    if (reason == ESP_RST_POWERON || rtcArea.magic != CRASH_LOG_MAGIC || rtcArea.magicInverted != ~(uint32_t)CRASH_LOG_MAGIC) {
+        return;
+    }
+    previous.valid = true;
+
+    const CrashStateSnapshot& state = rtcArea.state;
+    if (state.crc == itemCrc(state)) {
+        previous.stateValid = true;
+        previous.uptimeMs = state.uptimeMs;
+        previous.targetSpeed = state.targetSpeed;
+        previous.currentSpeed = state.currentSpeed;
+        previous.direction = state.flags & STATE_DIRECTION;
+        previous.enabled = state.flags & STATE_ENABLED;
+        previous.firingThrusters = state.flags & STATE_FIRING;
+        previous.emergencyStop = state.flags & STATE_EMERGENCY_STOP;
+        previous.minFreeHeap = state.minFreeHeap;
+    }
+
+    // Keep entries that pass their CRC, newest first (insertion sort by seq)
+    uint8_t count = 0;
+    for (int i = 0; i < CRASH_LOG_RECORDS; i++) {
+        const CrashLogEntry& entry = rtcArea.entries[i];
+        if (entry.crc != itemCrc(entry) || entry.length > CRASH_LOG_TEXT_LENGTH) {
+            continue;
+        }
+        int pos = count++;
+        while (pos > 0 && (int32_t)(previousEntries[pos - 1].seq - entry.seq) < 0) {
+            previousEntries[pos] = previousEntries[pos - 1];
+            pos--;
+        }
+        previousEntries[pos] = entry;
+    }
+    previous.recordCount = count;
+}
+
+void initCrashLog() {
+    recoverPreviousSession();
+
+    // Start this session's area
+    memset(&rtcArea, 0, sizeof(rtcArea));
+    rtcArea.magic = CRASH_LOG_MAGIC;
+    rtcArea.magicInverted = ~(uint32_t)CRASH_LOG_MAGIC;
+    rtcArea.state.crc = ~itemCrc(rtcArea.state); // Invalid until the first update
+    for (int i = 0; i < CRASH_LOG_RECORDS; i++) {
+        rtcArea.entries[i].crc = ~itemCrc(rtcArea.entries[i]);
+    }
+    Logger.addSink(rtcLogSink);
+
+    if (previous.valid) {
+        LOG_WARN("⚠️ Previous session ended by %s after %lu s (%u log lines recovered)",
+            previous.resetReason, (unsigned long)(previous.uptimeMs / 1000), previous.recordCount);
+    } else {
+        LOG_INFO("🧾 Crash log ready (reset reason: %s)", previous.resetReason);
+    }
+}
+
+void updateCrashLog() {
+    static unsigned long lastUpdate = 0;
+    if (millis() - lastUpdate < CRASH_LOG_STATE_INTERVAL_MS) return;
+    lastUpdate = millis();
+
+    RocketStateSnapshot snapshot = getRocketStateSnapshot();
+    CrashStateSnapshot& state = rtcArea.state;
+    state.crc = 0;
+    state.uptimeMs = millis();
+    state.targetSpeed = snapshot.targetSpeed;
+    state.currentSpeed = snapshot.currentSpeed;
+    state.flags = (snapshot.currentDirection ? STATE_DIRECTION : 0) |
+                  (snapshot.enabled ? STATE_ENABLED : 0) |
+                  (snapshot.firingThrusters ? STATE_FIRING : 0) |
+                  (snapshot.emergencyStop ? STATE_EMERGENCY_STOP : 0);
+    state.minFreeHeap = ESP.getMinFreeHeap();
+    state.crc = itemCrc(state);
+}
+
+const PreviousSession& getPreviousSession() {
+    return previous;
+}
+
+bool getPreviousSessionRecord(int index, LogRecord& out) {
+    if (index < 0 || index >= previous.recordCount) {
+        return false;
+    }
+
+    const CrashLogEntry& entry = previousEntries[index];
+    out.seq = entry.seq;
+    out.timestampMs = entry.timestampMs;
+    out.length = entry.length;
+    out.deferred = false;
+    memcpy(out.text, entry.text, entry.length);
+    out.text[out.length] = '\0';
+    return true;
+}
@@ -12,7 +12,7 @@ void initExhaustControl() {
     digitalWrite(PIN_EXHAUST_SOLENOID, LOW);
     digitalWrite(PIN_EXHAUST_IGNITER, LOW);
     
-    Logger.println("✅ Exhaust control initialized");
+    LOG_INFO("✅ Exhaust control initialized");
 }
 
 void updateExhaustControl() {
@@ -0,0 +1,43 @@
+#include "log_sinks.h"
+#include "config.h"
+#include "wifi_manager.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#ifdef LOG_SYSLOG_HOST
+
+// One RFC 3164 datagram per record to a local collector. Records wait in the
+// sink's backlog while WiFi is down and are sent once the station reconnects.
+class SyslogSink : public LogSink {
+public:
+    SyslogSink() : LogSink("syslog", LOG_SYSLOG_BACKLOG) {}
+
+    bool isReady() override {
+        return WiFi.status() == WL_CONNECTED;
+    }
+
+    bool writeRecord(const LogRecord& record) override {
+        // Facility user (1), severity informational (6)
+        if (!udp.beginPacket(LOG_SYSLOG_HOST, LOG_SYSLOG_PORT)) {
+            return false;
+        }
+        udp.printf("<14>%s: ", OTA_HOSTNAME);
+        udp.write((const uint8_t*)record.text, record.length);
+        return udp.endPacket() == 1;
+    }
+
+private:
+    WiFiUDP udp;
+};
+
+static SyslogSink syslogSink;
+
+#endif
+
+void initLogSinks() {
+#ifdef LOG_SYSLOG_HOST
+    Logger.addSink(syslogSink);
+    LOG_INFO("📜 Forwarding logs to syslog at %s:%d", LOG_SYSLOG_HOST, LOG_SYSLOG_PORT);
+#endif
+}
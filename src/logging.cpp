@@ -1,92 +1,535 @@
 #include "logging.h"
+#include "crash_log.h"
 #include <Arduino.h>
+#include <stdarg.h>
+
+static_assert((LOG_INDEX_SIZE & (LOG_INDEX_SIZE - 1)) == 0, "LOG_INDEX_SIZE must be a power of two");
+static_assert(LOG_ARENA_SIZE <= 65536, "Record offsets are 16-bit");
 
 LoggerClass Logger;
 
-LoggerClass::LoggerClass() : serialPrint(nullptr), logIndex(0), logCount(0), bufferPos(0) {
-    messageBuffer[0] = '\0';
+LoggerClass::LoggerClass() :
+    firstSeq(0),
+    nextSeq(0),
+    head(0),
+    bytesUsed(0),
+    evictedCount(0),
+    truncatedCount(0),
+    runtimeLevel(LOG_DEFAULT_RUNTIME_LEVEL),
+    sinkCount(0),
+    drainTask(nullptr)
+{
+    for (int i = 0; i < LOG_WRITER_SLOTS; i++) {
+        lineBuffers[i].owner = nullptr;
+        lineBuffers[i].length = 0;
+    }
 }
 
-void LoggerClass::addLogger(Print& print) {
-    serialPrint = &print;
+void LogArgPacker::add(const char* value) {
+    if (!value) value = "(null)";
+    size_t stringLength = strnlen(value, LOG_DEFERRED_MAX_STRING);
+    if (!reserve(2 + stringLength)) return;
+    data[length++] = ARG_STRING;
+    data[length++] = (uint8_t)stringLength;
+    put(value, stringLength);
 }
 
-size_t LoggerClass::write(uint8_t byte) {
-    size_t result = 0;
-    if (serialPrint) {
-        result = serialPrint->write(byte);
-    }
-    
-    if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1) {
-        messageBuffer[bufferPos++] = byte;
-        messageBuffer[bufferPos] = '\0';
-        
+PrintSink::PrintSink(const char* name, Print& print, uint16_t maxBacklog, bool checkSpace) :
+    LogSink(name, maxBacklog),
+    print(print),
+    checkSpace(checkSpace),
+    lineLength(0),
+    linePos(0)
+{
+}
+
+bool PrintSink::writeRecord(const LogRecord& record) {
+    if (!flushPending()) {
+        return false;
+    }
+    memcpy(line, record.text, record.length);
+    line[record.length] = '\r';
+    line[record.length + 1] = '\n';
+    lineLength = record.length + 2;
+    linePos = 0;
+    flushPending();
+    return true;
+}
+
+bool PrintSink::flushPending() {
+    if (linePos < lineLength) {
+        size_t count = lineLength - linePos;
+        if (checkSpace) {
+            int space = print.availableForWrite();
+            count = min(count, (size_t)max(space, 0));
+        }
+        if (count > 0) {
+            linePos += print.write((const uint8_t*)&line[linePos], count);
+        }
+    }
+    return linePos >= lineLength;
+}
+
+void LoggerClass::begin() {
+    if (drainTask) return;
+    xTaskCreatePinnedToCore(drainTaskMain, "log", LOG_DRAIN_TASK_STACK_SIZE, this,
+                            LOG_DRAIN_TASK_PRIORITY, &drainTask, LOG_DRAIN_TASK_CORE);
+}
+
+bool LoggerClass::addSink(LogSink& sink) {
+    bool added = false;
+
+    portENTER_CRITICAL(&lock);
+    bool duplicate = false;
+    for (int i = 0; i < sinkCount; i++) {
+        if (sinks[i] == &sink) duplicate = true;
+    }
+    if (!duplicate && sinkCount < LOG_MAX_SINKS) {
+        sink.cursor = firstSeq;
+        sinks[sinkCount] = &sink;
+        sinkCount = sinkCount + 1;
+        added = true;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (added && drainTask) {
+        xTaskNotifyGive(drainTask);
+    }
+    return added;
+}
+
+int LoggerClass::getSinkCount() {
+    return sinkCount;
+}
+
+LogSinkStats LoggerClass::getSinkStats(int index) {
+    LogSinkStats stats = {};
+    if (index < 0 || index >= sinkCount) {
+        return stats;
+    }
+
+    const LogSink* sink = sinks[index];
+    stats.name = sink->name;
+    stats.sent = sink->sent;
+    stats.dropped = sink->dropped;
+    uint32_t next = getNextSeq();
+    stats.backlog = min(next - sink->cursor, next - getFirstSeq());
+    return stats;
+}
+
+// Sends what the sink will take; returns true if it still has output waiting
+bool LoggerClass::drainSink(LogSink& sink, LogRecord& record) {
+    if (!sink.flushPending()) {
+        return true;
+    }
+
+    uint32_t first = getFirstSeq();
+    uint32_t next = getNextSeq();
+
+    // Drop-oldest: catch up with eviction and the sink's own backlog limit
+    uint32_t start = first;
+    if (next - first > sink.maxBacklog) {
+        start = next - sink.maxBacklog;
+    }
+    if (sink.cursor - start > next - start) {
+        sink.dropped += start - sink.cursor;
+        sink.cursor = start;
+    }
+
+    if (sink.cursor == next || !sink.isReady()) {
+        return false;
+    }
+
+    while (sink.cursor != next) {
+        if (!readRecord(sink.cursor, record)) {
+            // Evicted since we checked - the next pass skips ahead
+            return true;
+        }
+        if (!sink.writeRecord(record)) {
+            return true;
+        }
+        sink.cursor++;
+        sink.sent++;
+    }
+    return !sink.flushPending();
+}
+
+void LoggerClass::drainTaskMain(void* parameter) {
+    LoggerClass* logger = static_cast<LoggerClass*>(parameter);
+    static LogRecord record;    // Only touched by this task
+    bool pending = false;
+
+    for (;;) {
+        // Woken by every committed record, or periodically to retry stalled sinks
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(pending ? LOG_DRAIN_RETRY_MS : LOG_DRAIN_IDLE_MS));
+
+        pending = false;
+        int count = logger->sinkCount;
+        for (int i = 0; i < count; i++) {
+            if (logger->drainSink(*logger->sinks[i], record)) {
+                pending = true;
+            }
+        }
+    }
+}
+
+void LoggerClass::setLevel(uint8_t level) {
+    runtimeLevel = min<uint8_t>(level, LOG_LEVEL_TRACE);
+}
+
+const char* LoggerClass::getLevelName(uint8_t level) {
+    switch (level) {
+        case LOG_LEVEL_NONE:  return "none";
+        case LOG_LEVEL_ERROR: return "error";
+        case LOG_LEVEL_WARN:  return "warn";
+        case LOG_LEVEL_INFO:  return "info";
+        case LOG_LEVEL_DEBUG: return "debug";
+        case LOG_LEVEL_TRACE: return "trace";
+        default:              return "unknown";
+    }
+}
+
+uint32_t LoggerClass::recordSize(uint16_t length) {
+    // Header + text, padded so headers stay 4-byte aligned
+    return (sizeof(RecordHeader) + length + 3) & ~3u;
+}
+
+LoggerClass::LineBuffer* LoggerClass::acquireLineBuffer() {
+    void* owner = xTaskGetCurrentTaskHandle();
+    LineBuffer* freeSlot = nullptr;
+
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < LOG_WRITER_SLOTS; i++) {
+        if (lineBuffers[i].owner == owner) {
+            portEXIT_CRITICAL(&lock);
+            return &lineBuffers[i];
+        }
+        if (!freeSlot && lineBuffers[i].owner == nullptr) {
+            freeSlot = &lineBuffers[i];
+        }
+    }
+    if (freeSlot) {
+        freeSlot->owner = owner;
+        freeSlot->length = 0;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    return freeSlot;
+}
+
+void LoggerClass::releaseLineBuffer(LineBuffer* line) {
+    portENTER_CRITICAL(&lock);
+    line->owner = nullptr;
+    line->length = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+void LoggerClass::appendToLine(LineBuffer* line, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        uint8_t byte = data[i];
+
         if (byte == '\n' || byte == '\r') {
-            if (bufferPos > 1) {
-                messageBuffer[bufferPos - 1] = '\0';
-                String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-                addMessageToBuffer(timestampedMessage);
+            if (line->length > 0) {
+                commitRecord(line->text, line->length);
+                line->length = 0;
             }
-            bufferPos = 0;
-            messageBuffer[0] = '\0';
+        } else if (line->length < MAX_LOG_MESSAGE_LENGTH) {
+            line->text[line->length++] = (char)byte;
+        } else {
+            // Line too long - store what we have and continue on a new record
+            truncatedCount++;
+            commitRecord(line->text, line->length);
+            line->length = 0;
+            line->text[line->length++] = (char)byte;
         }
-    } else {
-        String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-        addMessageToBuffer(timestampedMessage);
-        bufferPos = 0;
-        messageBuffer[bufferPos++] = byte;
-        messageBuffer[bufferPos] = '\0';
     }
-    
-    return result;
 }
 
+void LoggerClass::commitRecord(const char* data, uint16_t length, uint16_t flags) {
+    uint32_t need = recordSize(length);
+
+    portENTER_CRITICAL(&lock);
+
+    // Records never wrap: if this one doesn't fit before the end of the arena,
+    // drop everything stored past head and continue from offset 0
+    if (head + need > LOG_ARENA_SIZE) {
+        while (nextSeq != firstSeq && recordOffsets[firstSeq & (LOG_INDEX_SIZE - 1)] >= head) {
+            const RecordHeader* oldest = (const RecordHeader*)&arena[recordOffsets[firstSeq & (LOG_INDEX_SIZE - 1)]];
+            bytesUsed -= recordSize(oldest->length);
+            firstSeq++;
+            evictedCount++;
+        }
+        head = 0;
+    }
+
+    // Evict the oldest records that overlap [head, head + need), and keep the index within bounds
+    while (nextSeq != firstSeq) {
+        uint32_t offset = recordOffsets[firstSeq & (LOG_INDEX_SIZE - 1)];
+        bool overlaps = offset >= head && offset < head + need;
+        if (!overlaps && nextSeq - firstSeq < LOG_INDEX_SIZE) {
+            break;
+        }
+        const RecordHeader* oldest = (const RecordHeader*)&arena[offset];
+        bytesUsed -= recordSize(oldest->length);
+        firstSeq++;
+        evictedCount++;
+    }
+
+    RecordHeader* header = (RecordHeader*)&arena[head];
+    header->seq = nextSeq;
+    header->timestampMs = millis();
+    header->length = length;
+    header->flags = flags;
+    memcpy(&arena[head + sizeof(RecordHeader)], data, length);
+
+    recordOffsets[nextSeq & (LOG_INDEX_SIZE - 1)] = (uint16_t)head;
+    nextSeq++;
+    head += need;
+    bytesUsed += need;
+
+    portEXIT_CRITICAL(&lock);
+
+    if (drainTask) {
+        xTaskNotifyGive(drainTask);
+    }
+}
+
+size_t LoggerClass::write(uint8_t byte) {
+    return write(&byte, 1);
+}
+
+// Never touches an output device: lines go into the ring and the drain task
+// delivers them to the sinks
 size_t LoggerClass::write(const uint8_t* buffer, size_t size) {
-    size_t result = 0;
-    if (serialPrint) {
-        result = serialPrint->write(buffer, size);
+    LineBuffer* line = acquireLineBuffer();
+    if (line) {
+        appendToLine(line, buffer, size);
+        if (line->length == 0) {
+            releaseLineBuffer(line);
+        }
+    } else {
+        // Every slot is busy - store this fragment as its own record
+        LineBuffer scratch;
+        scratch.length = 0;
+        appendToLine(&scratch, buffer, size);
+        if (scratch.length > 0) {
+            commitRecord(scratch.text, scratch.length);
+        }
     }
-    
-    for (size_t i = 0; i < size; i++) {
-        uint8_t byte = buffer[i];
-        
-        if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1) {
-            messageBuffer[bufferPos++] = byte;
-            messageBuffer[bufferPos] = '\0';
-            
-            if (byte == '\n' || byte == '\r') {
-                if (bufferPos > 1) {
-                    messageBuffer[bufferPos - 1] = '\0';
-                    String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-                    addMessageToBuffer(timestampedMessage);
+
+    return size;
+}
+
+size_t LoggerClass::printf(const char* format, ...) {
+    char buffer[MAX_LOG_MESSAGE_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0) {
+        return 0;
+    }
+    if (length >= (int)sizeof(buffer)) {
+        truncatedCount++;
+        length = sizeof(buffer) - 1;
+        buffer[length - 1] = '\n';
+    }
+    return write((const uint8_t*)buffer, length);
+}
+
+uint32_t LoggerClass::getFirstSeq() {
+    portENTER_CRITICAL(&lock);
+    uint32_t seq = firstSeq;
+    portEXIT_CRITICAL(&lock);
+    return seq;
+}
+
+uint32_t LoggerClass::getNextSeq() {
+    portENTER_CRITICAL(&lock);
+    uint32_t seq = nextSeq;
+    portEXIT_CRITICAL(&lock);
+    return seq;
+}
+
+bool LoggerClass::readRecord(uint32_t seq, LogRecord& out) {
+    bool found = false;
+
+    portENTER_CRITICAL(&lock);
+    if (seq - firstSeq < nextSeq - firstSeq) {
+        const RecordHeader* header = (const RecordHeader*)&arena[recordOffsets[seq & (LOG_INDEX_SIZE - 1)]];
+        out.seq = header->seq;
+        out.timestampMs = header->timestampMs;
+        out.length = header->length;
+        out.deferred = (header->flags & RECORD_DEFERRED) != 0;
+        memcpy(out.text, (const uint8_t*)header + sizeof(RecordHeader), header->length);
+        found = true;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (!found) {
+        return false;
+    }
+
+    if (out.deferred) {
+        // Format outside the lock from a copy of the packed arguments
+        uint8_t payload[LOG_DEFERRED_MAX_PAYLOAD];
+        uint16_t payloadLength = min<uint16_t>(out.length, sizeof(payload));
+        memcpy(payload, out.text, payloadLength);
+        out.length = formatDeferred(payload, payloadLength, out.text, sizeof(out.text));
+    }
+    out.text[out.length] = '\0';
+    return true;
+}
+
+// Rebuilds each printf conversion from the stored format and formats it against
+// the next packed argument, widening integers to long long. Mismatched argument
+// types are converted rather than reinterpreted, so a bad record can't crash the reader.
+uint16_t LoggerClass::formatDeferred(const uint8_t* payload, uint16_t length, char* out, size_t outSize) {
+    const char* format;
+    if (length < sizeof(format)) return 0;
+    memcpy(&format, payload, sizeof(format));
+    uint16_t pos = sizeof(format);
+
+    size_t used = 0;
+    auto append = [&](int written) {
+        if (written > 0) used = min(used + (size_t)written, outSize - 1);
+    };
+
+    for (const char* p = format; *p && used < outSize - 1; p++) {
+        if (*p != '%') {
+            out[used++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[used++] = '%';
+            p++;
+            continue;
+        }
+
+        // Copy flags, width and precision; drop length modifiers
+        char spec[24];
+        size_t specLength = 0;
+        spec[specLength++] = '%';
+        p++;
+        while (*p && strchr("-+ #0123456789.*hlLqjzt", *p)) {
+            if (*p == '*') {
+                // Width/precision argument: substitute its value
+                long long value = 0;
+                if (pos + 1 + sizeof(value) <= length && (payload[pos] == LogArgPacker::ARG_INT || payload[pos] == LogArgPacker::ARG_UINT)) {
+                    memcpy(&value, &payload[pos + 1], sizeof(value));
+                    pos += 1 + sizeof(value);
                 }
-                bufferPos = 0;
-                messageBuffer[0] = '\0';
+                specLength += snprintf(&spec[specLength], sizeof(spec) - specLength - 4, "%d", (int)value);
+            } else if (!strchr("hlLqjzt", *p) && specLength < sizeof(spec) - 4) {
+                spec[specLength++] = *p;
+            }
+            p++;
+        }
+        char conversion = *p;
+        if (!conversion) break;
+
+        if (pos >= length) {
+            append(snprintf(&out[used], outSize - used, "<?>"));
+            continue;
+        }
+
+        uint8_t type = payload[pos++];
+        long long intValue = 0;
+        double doubleValue = 0.0;
+        const void* pointerValue = nullptr;
+        char stringValue[LOG_DEFERRED_MAX_STRING + 1] = "";
+
+        // Every read is checked against the record, so a corrupt type or
+        // length byte prints "<?>" instead of reading past it
+        bool valid = true;
+        switch (type) {
+            case LogArgPacker::ARG_INT:
+            case LogArgPacker::ARG_UINT:
+                if (pos + sizeof(intValue) > length) { valid = false; break; }
+                memcpy(&intValue, &payload[pos], sizeof(intValue));
+                pos += sizeof(intValue);
+                doubleValue = (type == LogArgPacker::ARG_INT) ? (double)intValue : (double)(unsigned long long)intValue;
+                break;
+            case LogArgPacker::ARG_DOUBLE:
+                if (pos + sizeof(doubleValue) > length) { valid = false; break; }
+                memcpy(&doubleValue, &payload[pos], sizeof(doubleValue));
+                pos += sizeof(doubleValue);
+                intValue = (long long)doubleValue;
+                break;
+            case LogArgPacker::ARG_POINTER:
+                if (pos + sizeof(pointerValue) > length) { valid = false; break; }
+                memcpy(&pointerValue, &payload[pos], sizeof(pointerValue));
+                pos += sizeof(pointerValue);
+                break;
+            case LogArgPacker::ARG_STRING: {
+                if (pos >= length || pos + 1 + payload[pos] > length) { valid = false; break; }
+                uint8_t stringLength = min<uint8_t>(payload[pos], LOG_DEFERRED_MAX_STRING);
+                memcpy(stringValue, &payload[pos + 1], stringLength);
+                stringValue[stringLength] = '\0';
+                pos += 1 + payload[pos];
+                break;
             }
+            default:
+                valid = false;
+                break;
+        }
+        if (!valid) {
+            pos = length; // Corrupt record - stop consuming arguments
+            append(snprintf(&out[used], outSize - used, "<?>"));
+            continue;
+        }
+
+        if (type == LogArgPacker::ARG_STRING || conversion == 's') {
+            spec[specLength++] = 's';
+            spec[specLength] = '\0';
+            append(snprintf(&out[used], outSize - used, spec, type == LogArgPacker::ARG_STRING ? stringValue : "<?>"));
+        } else if (conversion == 'p' || type == LogArgPacker::ARG_POINTER) {
+            spec[specLength++] = 'p';
+            spec[specLength] = '\0';
+            append(snprintf(&out[used], outSize - used, spec, pointerValue));
+        } else if (strchr("fFeEgGaA", conversion)) {
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            append(snprintf(&out[used], outSize - used, spec, doubleValue));
+        } else if (conversion == 'c') {
+            spec[specLength++] = 'c';
+            spec[specLength] = '\0';
+            append(snprintf(&out[used], outSize - used, spec, (int)intValue));
         } else {
-            String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-            addMessageToBuffer(timestampedMessage);
-            bufferPos = 0;
-            messageBuffer[bufferPos++] = byte;
-            messageBuffer[bufferPos] = '\0';
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+            spec[specLength++] = strchr("diuoxX", conversion) ? conversion : 'd';
+            spec[specLength] = '\0';
+            append(snprintf(&out[used], outSize - used, spec, intValue));
         }
     }
-    
-    return result;
-}
 
-void LoggerClass::addMessageToBuffer(const String& message) {
-    logBuffer[logIndex] = message;
-    logIndex = (logIndex + 1) % LOG_BUFFER_SIZE;
-    
-    if (logCount < LOG_BUFFER_SIZE) {
-        logCount++;
+    // Records are single lines
+    while (used > 0 && (out[used - 1] == '\n' || out[used - 1] == '\r')) {
+        used--;
     }
+    out[used] = '\0';
+    return (uint16_t)used;
+}
+
+LogStats LoggerClass::getStats() {
+    LogStats stats;
+    portENTER_CRITICAL(&lock);
+    stats.records = nextSeq - firstSeq;
+    stats.bytesUsed = bytesUsed;
+    stats.written = nextSeq;
+    stats.evicted = evictedCount;
+    stats.truncated = truncatedCount;
+    portEXIT_CRITICAL(&lock);
+    return stats;
+}
+
+int LoggerClass::getLogCount() {
+    return (int)(getNextSeq() - getFirstSeq());
 }
 
-String LoggerClass::getLogsAsHtml() {
-    String html = R"(
-<!DOCTYPE html><html><head><title>System Logs</title>
+static const char LOG_PAGE_HEADER[] = R"(<!DOCTYPE html><html><head><title>System Logs</title>
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <meta http-equiv="refresh" content="5">
 <style>
@@ -101,45 +544,218 @@ body{font-family:monospace;margin:10px;background:#000;color:#0f0}
 <div class="nav">
 <a href="/">🏠 Home</a> | <a href="/logs">🔄 Refresh</a>
 </div>
-<div class="stats">Total Messages: )";
+)";
 
-    html += String(logCount);
-    html += " | Buffer: " + String(LOG_BUFFER_SIZE) + " | Free RAM: " + String(ESP.getFreeHeap()) + " bytes</div>";
-    
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            html += "<div class='log'>" + logBuffer[idx] + "</div>";
-        }
+LogStreamRenderer::LogStreamRenderer(LogStreamFormat format, uint32_t since) :
+    format(format),
+    stage(STAGE_HEADER),
+    firstSeq(Logger.getFirstSeq()),
+    endSeq(Logger.getNextSeq()),
+    shown(0),
+    dropped(0),
+    previousIndex(0),
+    piece(nullptr),
+    pieceLength(0),
+    piecePos(0)
+{
+    if (format == LOG_STREAM_HTML) {
+        seq = endSeq;
+    } else if (since - firstSeq <= endSeq - firstSeq) {
+        seq = since;
+    } else if ((int32_t)(since - endSeq) > 0) {
+        seq = endSeq;   // Cursor from the future (e.g. device rebooted) - nothing to send
     } else {
-        html += "<div class='log'>No log messages yet...</div>";
+        dropped = firstSeq - since;
+        seq = firstSeq;
     }
-    
-    html += "</body></html>";
-    return html;
 }
 
-String LoggerClass::getLogsAsJson() {
-    String json = "{\"logs\":[";
-    
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            if (i > 0) json += ",";
-            json += "\"" + logBuffer[idx] + "\"";
+size_t LogStreamRenderer::read(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+
+    while (written < maxLen) {
+        if (piecePos == pieceLength && !nextPiece()) {
+            break;
         }
+        size_t count = min(pieceLength - piecePos, maxLen - written);
+        memcpy(buffer + written, piece + piecePos, count);
+        piecePos += count;
+        written += count;
     }
-    
-    json += "],\"count\":" + String(logCount) + ",\"freeRam\":" + String(ESP.getFreeHeap()) + "}";
-    return json;
+    return written;
 }
 
-void LoggerClass::clearLogs() {
-    logIndex = 0;
-    logCount = 0;
-    bufferPos = 0;
-    messageBuffer[0] = '\0';
+void LogStreamRenderer::setPiece(const char* text, size_t length) {
+    piece = text;
+    pieceLength = length;
+    piecePos = 0;
 }
 
+// Appends text to the staging buffer, escaped for the output format
+size_t LogStreamRenderer::appendEscaped(size_t used, const char* text) {
+    for (const char* p = text; *p && used < sizeof(staging) - 8; p++) {
+        char c = *p;
+        const char* escape = nullptr;
+        if (format == LOG_STREAM_HTML) {
+            if (c == '<') escape = "&lt;";
+            else if (c == '>') escape = "&gt;";
+            else if (c == '&') escape = "&amp;";
+        } else {
+            if (c == '"') escape = "\\\"";
+            else if (c == '\\') escape = "\\\\";
+            else if (c == '\n') escape = "\\n";
+            else if (c == '\r') escape = "\\r";
+            else if (c == '\t') escape = "\\t";
+            else if ((uint8_t)c < 0x20) {
+                used += snprintf(&staging[used], 7, "\\u%04x", (uint8_t)c);
+                continue;
+            }
+        }
+        if (escape) {
+            size_t length = strlen(escape);
+            memcpy(&staging[used], escape, length);
+            used += length;
+        } else {
+            staging[used++] = c;
+        }
+    }
+    return used;
+}
+
+// Renders the next piece of output (static text or one record) - false when finished
+bool LogStreamRenderer::nextPiece() {
+    int length;
+
+    switch (stage) {
+        case STAGE_HEADER:
+            if (format == LOG_STREAM_HTML) {
+                setPiece(LOG_PAGE_HEADER, sizeof(LOG_PAGE_HEADER) - 1);
+                stage = STAGE_STATS;
+            } else {
+                setPiece("{\"logs\":[", 9);
+                stage = STAGE_RECORDS;
+            }
+            return true;
+
+        case STAGE_STATS: {
+            LogStats stats = Logger.getStats();
+            length = snprintf(staging, sizeof(staging),
+                "<div class=\"stats\">Total Messages: %lu | Buffer: %lu/%u bytes | Free RAM: %lu bytes</div>\n",
+                (unsigned long)stats.records, (unsigned long)stats.bytesUsed, (unsigned)LOG_ARENA_SIZE, (unsigned long)ESP.getFreeHeap());
+            setPiece(staging, length);
+            stage = STAGE_RECORDS;
+            return true;
+        }
+
+        case STAGE_RECORDS:
+            if (format == LOG_STREAM_HTML) {
+                // Newest first; stop early if the writer evicts what we haven't sent yet
+                while (seq != firstSeq) {
+                    seq--;
+                    if (!Logger.readRecord(seq, record)) {
+                        seq = firstSeq;
+                        break;
+                    }
+                    size_t used = snprintf(staging, sizeof(staging), "<div class='log'>%lums: ", (unsigned long)record.timestampMs);
+                    used = appendEscaped(used, record.text);
+                    memcpy(&staging[used], "</div>\n", 7);
+                    used += 7;
+                    shown++;
+                    setPiece(staging, used);
+                    return true;
+                }
+            } else {
+                // Oldest first from the cursor; skip forward past anything evicted meanwhile
+                while (seq != endSeq) {
+                    if (!Logger.readRecord(seq, record)) {
+                        uint32_t oldest = Logger.getFirstSeq();
+                        uint32_t skip = (oldest - seq <= endSeq - seq) ? oldest - seq : endSeq - seq;
+                        dropped += skip;
+                        seq += skip;
+                        continue;
+                    }
+                    seq++;
+                    size_t used = snprintf(staging, sizeof(staging), "%s{\"seq\":%lu,\"t\":%lu,\"msg\":\"",
+                        shown > 0 ? "," : "", (unsigned long)record.seq, (unsigned long)record.timestampMs);
+                    used = appendEscaped(used, record.text);
+                    memcpy(&staging[used], "\"}", 2);
+                    used += 2;
+                    shown++;
+                    setPiece(staging, used);
+                    return true;
+                }
+            }
+            if (format == LOG_STREAM_HTML) {
+                stage = STAGE_PREVIOUS;
+                if (shown == 0) {
+                    static const char empty[] = "<div class='log'>No log messages yet...</div>\n";
+                    setPiece(empty, sizeof(empty) - 1);
+                    return true;
+                }
+            } else {
+                stage = STAGE_FOOTER;
+            }
+            return nextPiece();
+
+        case STAGE_PREVIOUS: {
+            const PreviousSession& session = getPreviousSession();
+            stage = STAGE_PREVIOUS_RECORDS;
+            if (!session.valid) {
+                stage = STAGE_FOOTER;
+                return nextPiece();
+            }
+            if (session.stateValid) {
+                length = snprintf(staging, sizeof(staging),
+                    "<div class=\"header\"><h3>🕘 Previous session</h3></div>\n"
+                    "<div class=\"stats\">Ended by: %s | Uptime: %lu s | Speed: %.1f%%/%.1f%% (target/current) | "
+                    "Dir: %s | Enabled: %s | Firing: %s | E-stop: %s | Min free RAM: %lu bytes</div>\n",
+                    session.resetReason, (unsigned long)(session.uptimeMs / 1000), session.targetSpeed, session.currentSpeed,
+                    session.direction ? "FORWARD" : "REVERSE", session.enabled ? "YES" : "NO",
+                    session.firingThrusters ? "YES" : "NO", session.emergencyStop ? "YES" : "NO",
+                    (unsigned long)session.minFreeHeap);
+            } else {
+                length = snprintf(staging, sizeof(staging),
+                    "<div class=\"header\"><h3>🕘 Previous session</h3></div>\n"
+                    "<div class=\"stats\">Ended by: %s | No state snapshot</div>\n", session.resetReason);
+            }
+            setPiece(staging, length);
+            return true;
+        }
+
+        case STAGE_PREVIOUS_RECORDS:
+            if (getPreviousSessionRecord(previousIndex++, record)) {
+                size_t used = snprintf(staging, sizeof(staging), "<div class='log'>%lums: ", (unsigned long)record.timestampMs);
+                used = appendEscaped(used, record.text);
+                memcpy(&staging[used], "</div>\n", 7);
+                used += 7;
+                setPiece(staging, used);
+                return true;
+            }
+            stage = STAGE_FOOTER;
+            // fall through
+
+        case STAGE_FOOTER:
+            stage = STAGE_DONE;
+            if (format == LOG_STREAM_HTML) {
+                setPiece("</body></html>", 14);
+                return true;
+            }
+            length = snprintf(staging, sizeof(staging), "],\"next\":%lu,\"first\":%lu,\"dropped\":%lu,\"count\":%lu,\"freeRam\":%lu}",
+                (unsigned long)seq, (unsigned long)Logger.getFirstSeq(), (unsigned long)dropped,
+                (unsigned long)shown, (unsigned long)ESP.getFreeHeap());
+            setPiece(staging, length);
+            return true;
+
+        case STAGE_DONE:
+        default:
+            return false;
+    }
+}
+
+void LoggerClass::clearLogs() {
+    portENTER_CRITICAL(&lock);
+    firstSeq = nextSeq;
+    head = 0;
+    bytesUsed = 0;
+    portEXIT_CRITICAL(&lock);
+}
@@ -1,67 +1,66 @@
 #include <Arduino.h>
 #include "config.h"
 #include "logging.h"
+#include "log_sinks.h"
+#include "crash_log.h"
 #include "rocket_state.h"
+#include "command_bus.h"
 #include "motor_control.h"
 #include "physical_inputs.h"
 #include "exhaust_control.h"
 #include "wifi_manager.h"
 #include "serial_interface.h"
 #include "ble_interface.h"
+#include "rtos_tasks.h"
+#include "radio_profile.h"
 
 void setup() {
-    delay(1000); // Allow serial to initialize
+    // No startup delay: boot messages wait in the log ring (see /logs)
     
-    // Initialize logging first
-    Logger.addLogger(Serial);
+    // Initialize logging first (sinks are added by the interfaces that own them)
+    Logger.begin();
+    initCrashLog();
+    initLogSinks();
     Logger.println("\n\n=== Space Tornado Starting ===\n");
     
     // Initialize all systems
     initRocketState();
+    initCommandBus();
     initMotorControl();
     initPhysicalInputs();
     initExhaustControl();
     initSerialInterface();
     
+    // Persisted radio profile decides which stacks start; frees memory of the others
+    initRadioProfile();
+    
+    if (isRadioEnabled(RADIO_WIFI)) {
+        initOTA();
+        
+        // Start WiFi first so association runs while the Bluetooth stacks come up
+        initWiFi([]() {
+            LOG_INFO("✅ WiFi connected - web interface available");
+        });
+    }
+    
     // Initialize BLE (NimBLE - for Web Bluetooth)
-    initBLEInterface();
+    if (isRadioEnabled(RADIO_BLE)) {
+        initBLEInterface();
+    }
     
     // Initialize Bluetooth Classic (SPP - for serial terminal apps)
-    initBluetoothClassic();
-    
-    // Initialize WiFi (non-blocking, will connect in background)
-    initWiFi([]() {
-        Logger.println("✅ WiFi connected - web interface available");
-    });
+    if (isRadioEnabled(RADIO_SPP)) {
+        initBluetoothClassic();
+    }
     
-    // Initialize OTA
-    initOTA();
+    // Start fixed-rate tasks: control on core 1, network/comms on core 0
+    startRtosTasks();
     
-    Logger.println("✅ Space Tornado initialized and ready!");
+    LOG_INFO("✅ Space Tornado initialized and ready!");
 }
 
 void loop() {
-    // Handle WiFi management (non-blocking)
-    handleWiFiLoop();
-    
-    // Update physical inputs (potentiometer, buttons, switch)
-    updatePhysicalInputs();
-    
-    // Update motor control (acceleration curve)
-    updateMotorControl();
-    
-    // Update exhaust control
-    updateExhaustControl();
-    
-    // Handle serial interface (terminal commands)
-    updateSerialInterface();
-    
-    // Handle BLE interface (Web Bluetooth)
-    updateBLEInterface();
-    
-    // Handle Bluetooth Classic interface (serial terminal apps)
-    updateBluetoothClassic();
-    
-    // Small delay to prevent tight loop
-    delay(10);
+    // All periodic work runs in the tasks started by startRtosTasks();
+    // the Arduino loop task has nothing left to do.
+    vTaskDelete(NULL);
 }
@@ -20,7 +20,7 @@ void initMotorControl() {
     digitalWrite(PIN_MOTOR_DIRECTION, HIGH); // Forward
     ledcWrite(0, 0);                        // Zero speed
     
-    Logger.println("✅ Motor control initialized");
+    LOG_INFO("✅ Motor control initialized");
 }
 
 float calculateAcceleratedSpeed(float currentSpeed, float targetSpeed, float deltaTimeSeconds) {
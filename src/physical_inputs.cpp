@@ -2,91 +2,178 @@
 #include "config.h"
 #include "rocket_state.h"
 #include "motor_control.h"
+#include "command_bus.h"
+#include "speed_pot.h"
 #include "logging.h"
 #include <Arduino.h>
 
-static unsigned long lastDirectionButtonPress = 0;
-static unsigned long lastFireButtonPress = 0;
-static bool lastDirectionButtonState = HIGH;
-static bool lastFireButtonState = HIGH;
-static bool lastEnableSwitchState = HIGH;
+// Per-input debounce state machine. The GPIO interrupt only timestamps edges;
+// the control task reads the pin once it has been quiet for PHYSICAL_INPUT_SETTLE_MS,
+// so nothing ever blocks. Reading the level (rather than trusting the edge) also
+// filters the spurious interrupts GPIO36/39 can produce on the ESP32.
+struct DebouncedInput {
+    const char* name;
+    uint8_t pin;
+    volatile bool edgePending;          // Set by ISR, cleared by control task
+    volatile uint32_t firstEdgeUs;      // First edge since the last settled read
+    volatile uint32_t lastEdgeUs;       // Most recent edge
+    volatile uint32_t edges;
+    bool level;                         // Debounced level
+    uint32_t lastChangeMs;              // Last accepted level change
+    uint32_t lastReadMs;                // Last time the pin was sampled
+    uint32_t changes;
+    uint32_t lastLatencyUs;
+    uint32_t maxLatencyUs;
+};
+
+enum InputIndex { INPUT_ENABLE, INPUT_DIRECTION, INPUT_FIRE, INPUT_COUNT };
+
+static DebouncedInput inputs[INPUT_COUNT] = {
+    { "enable",    PIN_ENABLE_SWITCH },
+    { "direction", PIN_DIRECTION_BUTTON },
+    { "fire",      PIN_FIRE_BUTTON },
+};
+
+static portMUX_TYPE inputMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR onInputEdge(void* arg) {
+    DebouncedInput* input = static_cast<DebouncedInput*>(arg);
+    uint32_t now = micros();
+
+    portENTER_CRITICAL_ISR(&inputMux);
+    if (!input->edgePending) {
+        input->firstEdgeUs = now;
+        input->edgePending = true;
+    }
+    input->lastEdgeUs = now;
+    input->edges++;
+    portEXIT_CRITICAL_ISR(&inputMux);
+}
+
+// Returns true (and records latency) when the debounced level of an input changes
+static bool pollInput(DebouncedInput& input, uint32_t nowMs, uint32_t nowUs) {
+    bool pending;
+    uint32_t firstEdgeUs, lastEdgeUs;
+
+    portENTER_CRITICAL(&inputMux);
+    pending = input.edgePending;
+    firstEdgeUs = input.firstEdgeUs;
+    lastEdgeUs = input.lastEdgeUs;
+    portEXIT_CRITICAL(&inputMux);
+
+    if (!pending) {
+        // Safety net for a missed edge: occasionally re-read idle inputs
+        if (nowMs - input.lastReadMs < PHYSICAL_INPUT_RESYNC_MS) {
+            return false;
+        }
+        firstEdgeUs = nowUs;
+    } else if (nowUs - lastEdgeUs < PHYSICAL_INPUT_SETTLE_MS * 1000UL) {
+        return false; // Still bouncing
+    }
+
+    bool level = digitalRead(input.pin);
+    if (level != input.level && nowMs - input.lastChangeMs < PHYSICAL_INPUT_DEBOUNCE_MS) {
+        return false; // Too soon after the last change - keep the edge pending
+    }
+
+    portENTER_CRITICAL(&inputMux);
+    // Only clear if no new edge arrived while we were deciding
+    if (input.lastEdgeUs == lastEdgeUs) {
+        input.edgePending = false;
+    }
+    portEXIT_CRITICAL(&inputMux);
+
+    input.lastReadMs = nowMs;
+    if (level == input.level) {
+        return false;
+    }
+
+    input.level = level;
+    input.lastChangeMs = nowMs;
+    input.changes++;
+    input.lastLatencyUs = micros() - firstEdgeUs;
+    if (input.lastLatencyUs > input.maxLatencyUs) input.maxLatencyUs = input.lastLatencyUs;
+    return true;
+}
 
 void initPhysicalInputs() {
-    // Configure input pins
-    pinMode(PIN_DIRECTION_BUTTON, INPUT_PULLUP);
-    pinMode(PIN_FIRE_BUTTON, INPUT_PULLUP);
-    pinMode(PIN_ENABLE_SWITCH, INPUT_PULLUP);
-    // PIN_SPEED_POT is analog, no need to set mode
-    
-    // Read initial states
-    lastDirectionButtonState = digitalRead(PIN_DIRECTION_BUTTON);
-    lastFireButtonState = digitalRead(PIN_FIRE_BUTTON);
-    lastEnableSwitchState = digitalRead(PIN_ENABLE_SWITCH);
-    
+    uint32_t now = millis();
+
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        DebouncedInput& input = inputs[i];
+
+        // Configure input pins
+        pinMode(input.pin, INPUT_PULLUP);
+
+        // Read initial states
+        input.level = digitalRead(input.pin);
+        input.lastChangeMs = now;
+        input.lastReadMs = now;
+
+        attachInterruptArg(digitalPinToInterrupt(input.pin), onInputEdge, &input, CHANGE);
+    }
+    // PIN_SPEED_POT is sampled continuously by the ADC DMA controller
+    initSpeedPot();
+
     // Set initial enable state
-    setEnabled(!lastEnableSwitchState); // Switch pulled up, LOW when on
-    
-    Logger.println("✅ Physical inputs initialized");
+    setEnabled(!inputs[INPUT_ENABLE].level); // Switch pulled up, LOW when on
+
+    LOG_INFO("✅ Physical inputs initialized (interrupt-driven debounce)");
 }
 
 void updatePhysicalInputs() {
-    unsigned long currentTime = millis();
-    
-    // Read enable switch (debounced)
-    bool enableSwitchState = digitalRead(PIN_ENABLE_SWITCH);
-    if (enableSwitchState != lastEnableSwitchState) {
-        delay(PHYSICAL_INPUT_DEBOUNCE_MS);
-        enableSwitchState = digitalRead(PIN_ENABLE_SWITCH);
-        if (enableSwitchState != lastEnableSwitchState) {
-            setEnabled(!enableSwitchState); // Switch pulled up, LOW when on
-            lastEnableSwitchState = enableSwitchState;
-        }
+    uint32_t nowMs = millis();
+    uint32_t nowUs = micros();
+
+    // Enable switch
+    DebouncedInput& enableSwitch = inputs[INPUT_ENABLE];
+    if (pollInput(enableSwitch, nowMs, nowUs)) {
+        postCommand(CMD_SET_ENABLED, SOURCE_PHYSICAL, enableSwitch.level ? 0.0f : 1.0f); // Switch pulled up, LOW when on
     }
-    
-    // Read speed potentiometer (only if enabled)
-    if (isEnabled() && !isEmergencyStop()) {
-        int potValue = analogRead(PIN_SPEED_POT);
-        // Convert ADC reading (0-4095 for ESP32) to speed percentage (0-100)
-        float speedPercent = (potValue / 4095.0f) * MAX_MOTOR_SPEED;
-        updateTargetSpeed(speedPercent);
+
+    // Speed potentiometer: filtered continuously, target only updated when it moves
+    // (only if enabled; re-sent when the system becomes active)
+    static bool wasActive = false;
+    bool active = isEnabled() && !isEmergencyStop();
+    float speedPercent;
+    if (readSpeedPot(speedPercent, active && !wasActive) && active) {
+        postCommand(CMD_SET_SPEED, SOURCE_PHYSICAL, speedPercent);
     }
-    
-    // Read direction button (debounced, edge-triggered)
-    bool directionButtonState = digitalRead(PIN_DIRECTION_BUTTON);
-    if (directionButtonState == LOW && lastDirectionButtonState == HIGH) {
-        // Button pressed (edge detected)
-        if (currentTime - lastDirectionButtonPress > PHYSICAL_INPUT_DEBOUNCE_MS) {
-            // Toggle direction only if enabled
-            if (isEnabled()) {
-                updateTargetDirection(!getTargetDirection());
-            }
-            lastDirectionButtonPress = currentTime;
-        }
+    wasActive = active;
+
+    // Direction button (toggle on press; ignored by the control task unless enabled)
+    DebouncedInput& directionButton = inputs[INPUT_DIRECTION];
+    if (pollInput(directionButton, nowMs, nowUs) && directionButton.level == LOW) {
+        postCommand(CMD_TOGGLE_DIRECTION, SOURCE_PHYSICAL);
     }
-    lastDirectionButtonState = directionButtonState;
-    
-    // Read fire thrusters button (debounced, only if enabled)
-    if (isEnabled() && !isEmergencyStop()) {
-        bool fireButtonState = digitalRead(PIN_FIRE_BUTTON);
-        if (fireButtonState == LOW && lastFireButtonState == HIGH) {
-            // Button pressed (edge detected)
-            if (currentTime - lastFireButtonPress > PHYSICAL_INPUT_DEBOUNCE_MS) {
-                setFiringThrusters(true);
-                lastFireButtonPress = currentTime;
-            }
-        } else if (fireButtonState == HIGH && lastFireButtonState == LOW) {
-            // Button released
-            if (currentTime - lastFireButtonPress > PHYSICAL_INPUT_DEBOUNCE_MS) {
-                setFiringThrusters(false);
-            }
-        }
-        lastFireButtonState = fireButtonState;
-    } else {
+
+    // Fire thrusters button (hold to fire)
+    DebouncedInput& fireButton = inputs[INPUT_FIRE];
+    if (pollInput(fireButton, nowMs, nowUs) && isEnabled() && !isEmergencyStop()) {
+        postCommand(CMD_FIRE, SOURCE_PHYSICAL, fireButton.level == LOW ? 1.0f : 0.0f);
+    }
+    if ((!isEnabled() || isEmergencyStop()) && isFiringThrusters()) {
         // System disabled or emergency stop - ensure thrusters are off
-        if (isFiringThrusters()) {
-            setFiringThrusters(false);
-        }
-        lastFireButtonState = digitalRead(PIN_FIRE_BUTTON);
+        postCommand(CMD_FIRE, SOURCE_PHYSICAL, 0.0f);
     }
 }
 
+int getPhysicalInputCount() {
+    return INPUT_COUNT;
+}
+
+PhysicalInputStats getPhysicalInputStats(int index) {
+    PhysicalInputStats stats = {};
+    if (index < 0 || index >= INPUT_COUNT) {
+        return stats;
+    }
+
+    const DebouncedInput& input = inputs[index];
+    stats.name = input.name;
+    stats.level = input.level;
+    stats.edges = input.edges;
+    stats.changes = input.changes;
+    stats.lastLatencyUs = input.lastLatencyUs;
+    stats.maxLatencyUs = input.maxLatencyUs;
+    return stats;
+}
@@ -0,0 +1,231 @@
+#include "radio_profile.h"
+#include "config.h"
+#include "logging.h"
+#include "command_bus.h"
+#include "rtos_tasks.h"
+#include "ble_interface.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_bt.h>
+#include <atomic>
+
+// Index order is what "P<n>" selects
+static const RadioProfile PROFILES[] = {
+    { "all",      RADIO_WIFI | RADIO_BLE | RADIO_SPP },
+    { "wifi-ble", RADIO_WIFI | RADIO_BLE },
+    { "wifi",     RADIO_WIFI },
+    { "ble",      RADIO_BLE },
+    { "spp",      RADIO_SPP },
+    { "wifi-spp", RADIO_WIFI | RADIO_SPP },
+    { "ble-spp",  RADIO_BLE | RADIO_SPP },
+};
+
+static constexpr int PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+static_assert(RADIO_DEFAULT_PROFILE >= 0 && RADIO_DEFAULT_PROFILE < PROFILE_COUNT, "RADIO_DEFAULT_PROFILE out of range");
+
+static int activeProfile = RADIO_DEFAULT_PROFILE;
+static std::atomic<int> pendingProfile(-1);
+static std::atomic<uint32_t> restartAtMs(0);
+
+// Written by the network task, read by web handlers. Each NVS access opens its
+// own Preferences handle, since setRadioProfile() may run on any task.
+static portMUX_TYPE radioMux = portMUX_INITIALIZER_UNLOCKED;
+static RadioProfileMetrics metrics[PROFILE_COUNT];
+static bool metricsValid[PROFILE_COUNT];
+
+static void metricsKey(int index, char* key) {
+    key[0] = 'm';
+    key[1] = '0' + index;
+    key[2] = '\0';
+}
+
+// Releases controller (and, with no Bluetooth at all, Bluedroid host) memory
+// for the modes this profile doesn't use. Irreversible until the next reset.
+static void releaseUnusedBluetooth(uint8_t stacks) {
+    uint32_t heapBefore = ESP.getFreeHeap();
+    esp_err_t err = ESP_OK;
+
+    if (!(stacks & (RADIO_BLE | RADIO_SPP))) {
+        err = esp_bt_mem_release(ESP_BT_MODE_BTDM);
+    } else if (!(stacks & RADIO_SPP)) {
+        err = esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
+    } else if (!(stacks & RADIO_BLE)) {
+        err = esp_bt_controller_mem_release(ESP_BT_MODE_BLE);
+        // BluetoothSerial would start the controller in dual mode, which needs the BLE memory
+        if (err == ESP_OK && !btStartMode(BT_MODE_CLASSIC_BT)) {
+            LOG_ERROR("❌ Bluetooth controller failed to start in Classic mode");
+        }
+    } else {
+        return;
+    }
+
+    if (err != ESP_OK) {
+        LOG_WARN("⚠️ Bluetooth memory release failed: %d", err);
+        return;
+    }
+    LOG_INFO("📻 Released %lu bytes of unused Bluetooth memory",
+        (unsigned long)(ESP.getFreeHeap() - heapBefore));
+}
+
+void initRadioProfile() {
+    Preferences radioPrefs;
+    if (radioPrefs.begin("radio", false)) {
+        int stored = radioPrefs.getUChar("profile", RADIO_DEFAULT_PROFILE);
+        activeProfile = (stored < PROFILE_COUNT) ? stored : RADIO_DEFAULT_PROFILE;
+
+        for (int i = 0; i < PROFILE_COUNT; i++) {
+            char key[3];
+            metricsKey(i, key);
+            metricsValid[i] = radioPrefs.getBytes(key, &metrics[i], sizeof(metrics[i])) == sizeof(metrics[i]);
+        }
+        radioPrefs.end();
+    } else {
+        LOG_WARN("⚠️ Failed to open radio preferences - using the default profile");
+    }
+
+    // This run replaces the stored one
+    RadioProfileMetrics& current = metrics[activeProfile];
+    uint32_t boots = metricsValid[activeProfile] ? current.boots + 1 : 1;
+    current = {};
+    current.boots = boots;
+    metricsValid[activeProfile] = true;
+
+    const RadioProfile& profile = PROFILES[activeProfile];
+    LOG_INFO("📻 Radio profile: %s (WiFi %s, BLE %s, SPP %s)", profile.name,
+        (profile.stacks & RADIO_WIFI) ? "on" : "off",
+        (profile.stacks & RADIO_BLE) ? "on" : "off",
+        (profile.stacks & RADIO_SPP) ? "on" : "off");
+    releaseUnusedBluetooth(profile.stacks);
+}
+
+static void saveMetrics() {
+    RadioProfileMetrics copy;
+    portENTER_CRITICAL(&radioMux);
+    copy = metrics[activeProfile];
+    portEXIT_CRITICAL(&radioMux);
+
+    Preferences radioPrefs;
+    if (!radioPrefs.begin("radio", false)) return;
+    char key[3];
+    metricsKey(activeProfile, key);
+    radioPrefs.putBytes(key, &copy, sizeof(copy));
+    radioPrefs.end();
+}
+
+static void sampleMetrics() {
+    RadioProfileMetrics sample = {};
+    sample.uptimeS = millis() / 1000;
+    sample.freeHeap = ESP.getFreeHeap();
+    sample.minFreeHeap = ESP.getMinFreeHeap();
+    sample.largestFreeBlock = ESP.getMaxAllocHeap();
+
+    for (int i = 0; i < getTaskCount(); i++) {
+        TaskTimingStats task = getTaskStats(i);
+        if (strcmp(task.name, "control") == 0) {
+            sample.controlJitterMaxUs = task.maxJitterUs;
+        }
+    }
+    sample.commandLatencyMaxUs = getCommandBusStats().maxLatencyUs;
+
+    // Slowest central that has been driving
+    for (int i = 0; i < getBleConnectionCount(); i++) {
+        BleConnectionStats ble;
+        if (getBleConnectionStats(i, ble) && ble.latencySamples > 0 && ble.avgLatencyUs > sample.bleLatencyAvgUs) {
+            sample.bleLatencyAvgUs = ble.avgLatencyUs;
+        }
+    }
+
+    portENTER_CRITICAL(&radioMux);
+    RadioProfileMetrics& current = metrics[activeProfile];
+    if (current.bootFreeHeap == 0) {
+        current.bootFreeHeap = sample.freeHeap;     // First sample: setup() has just finished
+    }
+    current.uptimeS = sample.uptimeS;
+    current.freeHeap = sample.freeHeap;
+    current.minFreeHeap = sample.minFreeHeap;
+    current.largestFreeBlock = sample.largestFreeBlock;
+    if (sample.controlJitterMaxUs > current.controlJitterMaxUs) current.controlJitterMaxUs = sample.controlJitterMaxUs;
+    if (sample.commandLatencyMaxUs > current.commandLatencyMaxUs) current.commandLatencyMaxUs = sample.commandLatencyMaxUs;
+    // Keep the last value seen while a central was connected
+    if (sample.bleLatencyAvgUs != 0) current.bleLatencyAvgUs = sample.bleLatencyAvgUs;
+    portEXIT_CRITICAL(&radioMux);
+}
+
+void updateRadioProfile() {
+    static bool sampled = false;
+    static unsigned long lastSample = 0;
+    static unsigned long lastSave = 0;
+
+    if (!sampled || millis() - lastSample >= RADIO_METRICS_SAMPLE_INTERVAL_MS) {
+        lastSample = millis();
+        sampleMetrics();
+    }
+    // Save once right after boot (counts the boot and its heap), then periodically
+    if (!sampled || millis() - lastSave >= RADIO_METRICS_SAVE_INTERVAL_MS) {
+        sampled = true;
+        lastSave = millis();
+        saveMetrics();
+    }
+
+    int pending = pendingProfile.load();
+    if (pending >= 0 && (int32_t)(millis() - restartAtMs.load()) >= 0) {
+        sampleMetrics();
+        saveMetrics();
+        LOG_WARN("📻 Restarting into radio profile %s", PROFILES[pending].name);
+        ESP.restart();
+    }
+}
+
+bool isRadioEnabled(RadioStack stack) {
+    return PROFILES[activeProfile].stacks & stack;
+}
+
+int getRadioProfileCount() {
+    return PROFILE_COUNT;
+}
+
+const RadioProfile& getRadioProfile(int index) {
+    return PROFILES[(index >= 0 && index < PROFILE_COUNT) ? index : activeProfile];
+}
+
+int findRadioProfile(const char* name) {
+    for (int i = 0; i < PROFILE_COUNT; i++) {
+        if (strcasecmp(PROFILES[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+int getActiveRadioProfile() {
+    return activeProfile;
+}
+
+int getPendingRadioProfile() {
+    return pendingProfile.load();
+}
+
+bool getRadioProfileMetrics(int index, RadioProfileMetrics& out) {
+    if (index < 0 || index >= PROFILE_COUNT) return false;
+    portENTER_CRITICAL(&radioMux);
+    bool valid = metricsValid[index];
+    out = metrics[index];
+    portEXIT_CRITICAL(&radioMux);
+    return valid;
+}
+
+bool setRadioProfile(int index) {
+    if (index < 0 || index >= PROFILE_COUNT) return false;
+
+    Preferences radioPrefs;
+    if (!radioPrefs.begin("radio", false)) {
+        LOG_ERROR("❌ Failed to open radio preferences for writing");
+        return false;
+    }
+    radioPrefs.putUChar("profile", index);
+    radioPrefs.end();
+
+    LOG_INFO("📻 Radio profile %s selected - restarting in %d ms", PROFILES[index].name, RADIO_RESTART_DELAY_MS);
+    restartAtMs.store(millis() + RADIO_RESTART_DELAY_MS);
+    pendingProfile.store(index);
+    return true;
+}
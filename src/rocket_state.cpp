@@ -1,8 +1,13 @@
 #include "rocket_state.h"
 #include "logging.h"
+#include "seqlock.h"
+#include <math.h>
 
 RocketState rocketState;
 
+static SeqLock<RocketStateSnapshot> publishedState;
+static RocketStateSnapshot lastPublished;
+
 void initRocketState() {
     rocketState.targetSpeed = 0.0f;
     rocketState.currentSpeed = 0.0f;
@@ -13,8 +18,9 @@ void initRocketState() {
     rocketState.emergencyStop = false;
     rocketState.lastSpeedUpdate = millis();
     rocketState.approximateVelocity = 0.0f;
+    publishRocketState();
     
-    Logger.println("✅ Rocket state initialized");
+    LOG_INFO("✅ Rocket state initialized");
 }
 
 void updateTargetSpeed(float speed) {
@@ -22,21 +28,21 @@ void updateTargetSpeed(float speed) {
     if (speed > MAX_MOTOR_SPEED) speed = MAX_MOTOR_SPEED;
     
     rocketState.targetSpeed = speed;
-    Logger.printf("🎯 Target speed set to: %.1f%%\n", speed);
+    LOG_FAST(LOG_LEVEL_INFO, "🎯 Target speed set to: %.1f%%", speed);
 }
 
 void updateTargetDirection(bool forward) {
     rocketState.targetDirection = forward;
-    Logger.printf("🎯 Target direction set to: %s\n", forward ? "FORWARD" : "REVERSE");
+    LOG_FAST(LOG_LEVEL_INFO, "🎯 Target direction set to: %s", forward ? "FORWARD" : "REVERSE");
 }
 
 void setEmergencyStop(bool stop) {
     rocketState.emergencyStop = stop;
     if (stop) {
         rocketState.targetSpeed = 0.0f;
-        Logger.println("🛑 EMERGENCY STOP ACTIVATED");
+        LOG_FAST(LOG_LEVEL_WARN, "🛑 EMERGENCY STOP ACTIVATED");
     } else {
-        Logger.println("✅ Emergency stop cleared");
+        LOG_FAST(LOG_LEVEL_INFO, "✅ Emergency stop cleared");
     }
 }
 
@@ -45,18 +51,18 @@ void setEnabled(bool enabled) {
     if (!enabled) {
         // When disabled, set target speed to 0
         rocketState.targetSpeed = 0.0f;
-        Logger.println("🔒 System disabled");
+        LOG_FAST(LOG_LEVEL_INFO, "🔒 System disabled");
     } else {
-        Logger.println("🔓 System enabled");
+        LOG_FAST(LOG_LEVEL_INFO, "🔓 System enabled");
     }
 }
 
 void setFiringThrusters(bool firing) {
     rocketState.firingThrusters = firing;
     if (firing) {
-        Logger.println("🔥 THRUSTERS FIRING!");
+        LOG_FAST(LOG_LEVEL_INFO, "🔥 THRUSTERS FIRING!");
     } else {
-        Logger.println("💨 Thrusters stopped");
+        LOG_FAST(LOG_LEVEL_INFO, "💨 Thrusters stopped");
     }
 }
 
@@ -92,3 +98,46 @@ float getApproximateVelocity() {
     return rocketState.approximateVelocity;
 }
 
+// Published resolution (see TelemetryFrame): 0.1 % speed, 0.01 velocity.
+// The acceleration curve and the velocity integration keep creeping by far
+// less than that for minutes after a change.
+static int32_t speedTenths(float speed) {
+    return (int32_t)lroundf(speed * 10.0f);
+}
+
+static int32_t velocityHundredths(float velocity) {
+    return (int32_t)lroundf(velocity * 100.0f);
+}
+
+void publishRocketState() {
+    RocketStateSnapshot next = lastPublished;
+    next.targetSpeed = rocketState.targetSpeed;
+    next.currentSpeed = rocketState.currentSpeed;
+    next.approximateVelocity = rocketState.approximateVelocity;
+    next.targetDirection = rocketState.targetDirection;
+    next.currentDirection = rocketState.currentDirection;
+    next.enabled = rocketState.enabled;
+    next.firingThrusters = rocketState.firingThrusters;
+    next.emergencyStop = rocketState.emergencyStop;
+    
+    // Only publish (and bump the version) when something changed at the published resolution
+    bool changed = lastPublished.version == 0 ||
+        speedTenths(next.targetSpeed) != speedTenths(lastPublished.targetSpeed) ||
+        speedTenths(next.currentSpeed) != speedTenths(lastPublished.currentSpeed) ||
+        velocityHundredths(next.approximateVelocity) != velocityHundredths(lastPublished.approximateVelocity) ||
+        next.targetDirection != lastPublished.targetDirection ||
+        next.currentDirection != lastPublished.currentDirection ||
+        next.enabled != lastPublished.enabled ||
+        next.firingThrusters != lastPublished.firingThrusters ||
+        next.emergencyStop != lastPublished.emergencyStop;
+    if (!changed) return;
+    
+    next.changedAtMs = millis();
+    next.version = lastPublished.version + 1;
+    publishedState.write(next);
+    lastPublished = next;
+}
+
+RocketStateSnapshot getRocketStateSnapshot() {
+    return publishedState.read();
+}
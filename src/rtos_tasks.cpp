@@ -0,0 +1,143 @@
+#include "rtos_tasks.h"
+#include "config.h"
+#include "logging.h"
+#include "rocket_state.h"
+#include "command_bus.h"
+#include "motor_control.h"
+#include "physical_inputs.h"
+#include "exhaust_control.h"
+#include "wifi_manager.h"
+#include "web_interface.h"
+#include "udp_control.h"
+#include "serial_interface.h"
+#include "ble_interface.h"
+#include "crash_log.h"
+#include "telemetry.h"
+#include "radio_profile.h"
+#include <Arduino.h>
+
+struct PeriodicTask {
+    const char* name;
+    void (*body)();
+    uint32_t periodMs;
+    UBaseType_t priority;
+    BaseType_t core;
+    uint32_t stackSize;
+    TaskTimingStats stats;
+    TaskHandle_t handle;
+};
+
+// Control path: inputs -> queued commands -> acceleration ramp -> PWM/exhaust outputs -> telemetry frame
+static void controlTick() {
+    updatePhysicalInputs();
+    processCommands();
+    updateMotorControl();
+    updateExhaustControl();
+    publishRocketState();
+    updateTelemetry();
+}
+
+// WiFi state machine, setup portal DNS, OTA, WebSocket and UDP state push, radio profile metrics
+static void networkTick() {
+    handleWiFiLoop();
+    handleWebInterface();
+    updateUdpControl();
+    updateRadioProfile();
+}
+
+// Terminal and Bluetooth command interfaces, telemetry pushes, crash-log state snapshot
+static void commsTick() {
+    updateSerialInterface();
+    updateBLEInterface();
+    updateBluetoothClassic();
+    dispatchTelemetry();
+    updateCrashLog();
+}
+
+static PeriodicTask tasks[] = {
+    { "control", controlTick, CONTROL_TASK_PERIOD_MS, CONTROL_TASK_PRIORITY, CONTROL_TASK_CORE, CONTROL_TASK_STACK_SIZE, {}, nullptr },
+    { "network", networkTick, NETWORK_TASK_PERIOD_MS, NETWORK_TASK_PRIORITY, COMMS_TASK_CORE, NETWORK_TASK_STACK_SIZE, {}, nullptr },
+    { "comms",   commsTick,   COMMS_TASK_PERIOD_MS,   COMMS_TASK_PRIORITY,   COMMS_TASK_CORE, COMMS_TASK_STACK_SIZE,   {}, nullptr },
+};
+
+static const int TASK_COUNT = sizeof(tasks) / sizeof(tasks[0]);
+
+static void periodicTaskLoop(void* param) {
+    PeriodicTask* task = static_cast<PeriodicTask*>(param);
+    TaskTimingStats& stats = task->stats;
+    const TickType_t periodTicks = pdMS_TO_TICKS(task->periodMs);
+
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t lastStartUs = 0;
+
+    for (;;) {
+        uint32_t startUs = micros();
+        task->body();
+        uint32_t runUs = micros() - startUs;
+
+        stats.lastRunUs = runUs;
+        if (runUs > stats.maxRunUs) stats.maxRunUs = runUs;
+
+        if (stats.iterations > 0) {
+            uint32_t periodUs = startUs - lastStartUs;
+            uint32_t jitterUs = (periodUs > stats.periodUs) ? periodUs - stats.periodUs : stats.periodUs - periodUs;
+            stats.lastPeriodUs = periodUs;
+            stats.lastJitterUs = jitterUs;
+            if (periodUs > stats.maxPeriodUs) stats.maxPeriodUs = periodUs;
+            if (jitterUs > stats.maxJitterUs) stats.maxJitterUs = jitterUs;
+        }
+        lastStartUs = startUs;
+        stats.iterations++;
+
+        // xTaskDelayUntil returns pdFALSE when the next wake time has already passed
+        if (xTaskDelayUntil(&lastWake, periodTicks) == pdFALSE) {
+            stats.missedDeadlines++;
+        }
+    }
+}
+
+void startRtosTasks() {
+    for (int i = 0; i < TASK_COUNT; i++) {
+        PeriodicTask& task = tasks[i];
+        task.stats.name = task.name;
+        task.stats.periodUs = task.periodMs * 1000;
+
+        BaseType_t result = xTaskCreatePinnedToCore(
+            periodicTaskLoop,
+            task.name,
+            task.stackSize,
+            &task,
+            task.priority,
+            &task.handle,
+            task.core
+        );
+
+        if (result == pdPASS) {
+            LOG_INFO("✅ Task '%s' started: %lu ms period, priority %u, core %d",
+                task.name, (unsigned long)task.periodMs, (unsigned)task.priority, (int)task.core);
+        } else {
+            LOG_ERROR("❌ Failed to start task '%s'", task.name);
+        }
+    }
+}
+
+int getTaskCount() {
+    return TASK_COUNT;
+}
+
+TaskTimingStats getTaskStats(int index) {
+    if (index < 0 || index >= TASK_COUNT) {
+        return TaskTimingStats();
+    }
+    return tasks[index].stats;
+}
+
+void resetTaskStats() {
+    for (int i = 0; i < TASK_COUNT; i++) {
+        TaskTimingStats& stats = tasks[i].stats;
+        stats.maxPeriodUs = 0;
+        stats.maxJitterUs = 0;
+        stats.maxRunUs = 0;
+        stats.missedDeadlines = 0;
+    }
+}
@@ -1,103 +1,60 @@
 #include "serial_interface.h"
 #include "config.h"
-#include "rocket_state.h"
+#include "telemetry.h"
+#include "command_parser.h"
 #include "logging.h"
 #include <Arduino.h>
 
-static String serialBuffer = "";
 static unsigned long lastSerialInput = 0;
 
+static void printSerialStatus(const TelemetryFrame& frame, uint8_t level) {
+    if (level > LOG_LOCAL_LEVEL || !Logger.isLevelEnabled(level)) return;
+    char status[128];
+    formatTelemetryText(frame, status, sizeof(status));
+    LOG_AT(level, "📊 Status - %s", status);
+}
+
+// Periodic status at debug level, pushed by the telemetry hub on change
+static void onSerialTelemetry(const TelemetryFrame& frame, void* context) {
+    printSerialStatus(frame, LOG_LEVEL_DEBUG);
+}
+
+static void handleSerialCommand(const ParsedCommand& cmd, void* context) {
+    if (cmd.op == '?') {
+        printSerialStatus(getTelemetryFrame(), LOG_LEVEL_INFO);
+    } else if (!postParsedCommand(cmd, SOURCE_SERIAL)) {
+        if (cmd.op == 'P') {
+            LOG_WARN("⚠️ Unknown radio profile %d", (int)cmd.value);
+        } else {
+            LOG_WARN("⚠️ Command queue full - command dropped");
+        }
+    }
+}
+
+static CommandParser serialParser(handleSerialCommand);
+static PrintSink serialLogSink("serial", Serial);
+
 void initSerialInterface() {
+    // TX buffer so log lines are queued for the UART instead of waiting on the 128-byte FIFO
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER_SIZE);
     Serial.begin(115200);
-    Logger.addLogger(Serial);
-    Logger.println("✅ Serial interface initialized");
-    Logger.println("Commands: + (speed+10%), - (speed-10%), D (forward), R (reverse), F (fire), X (stop)");
+    Logger.addSink(serialLogSink);
+    subscribeTelemetry("serial", { SERIAL_TELEMETRY_MIN_INTERVAL_MS, SERIAL_TELEMETRY_HEARTBEAT_MS,
+        TEXT_TELEMETRY_SPEED_DEADBAND, 10, TELEMETRY_FIELD_ALL }, onSerialTelemetry);
+    LOG_INFO("✅ Serial interface initialized");
+    LOG_INFO("Commands: + (speed+10%%), - (speed-10%%), S## (set speed), D (forward), R (reverse), F/f (fire/stop), X (stop), C (clear stop), L# (log level 0-5), P# (radio profile), ? (status)");
 }
 
 void updateSerialInterface() {
-    // Read available serial input
-    while (Serial.available()) {
-        char c = Serial.read();
+    // Feed available serial input to the shared command parser (bounded per tick)
+    int budget = COMMAND_MAX_BYTES_PER_TICK;
+    while (budget-- > 0 && Serial.available()) {
+        serialParser.feed((char)Serial.read());
         lastSerialInput = millis();
-        
-        // Process commands immediately (single character commands)
-        switch (c) {
-            case '+': {
-                float newSpeed = getTargetSpeedPercent() + SPEED_INCREMENT;
-                if (newSpeed > MAX_MOTOR_SPEED) newSpeed = MAX_MOTOR_SPEED;
-                updateTargetSpeed(newSpeed);
-                Logger.printf("📈 Speed increased to %.1f%%\n", newSpeed);
-                break;
-            }
-            case '-': {
-                float newSpeed = getTargetSpeedPercent() - SPEED_INCREMENT;
-                if (newSpeed < 0.0f) newSpeed = 0.0f;
-                updateTargetSpeed(newSpeed);
-                Logger.printf("📉 Speed decreased to %.1f%%\n", newSpeed);
-                break;
-            }
-            case 'R':
-            case 'r': {
-                // Toggle direction (reverse)
-                updateTargetDirection(false);
-                Logger.println("🔄 Direction set to REVERSE");
-                break;
-            }
-            case 'D':
-            case 'd': {
-                // Set direction forward
-                updateTargetDirection(true);
-                Logger.println("🔄 Direction set to FORWARD");
-                break;
-            }
-            case 'F':
-            case 'f': {
-                if (isEnabled() && !isEmergencyStop()) {
-                    setFiringThrusters(true);
-                    Logger.println("🔥 THRUSTERS FIRED!");
-                    // Auto-stop after 2 seconds for safety (user can press again to continue)
-                    // In a real scenario, you might want to require continuous 'F' presses
-                } else {
-                    Logger.println("⚠️ Cannot fire thrusters - system disabled or emergency stop active");
-                }
-                break;
-            }
-            case 'X':
-            case 'x': {
-                setEmergencyStop(true);
-                Logger.println("🛑 EMERGENCY STOP ACTIVATED");
-                break;
-            }
-            case '\n':
-            case '\r':
-                // Ignore newlines
-                break;
-            default:
-                // Add to buffer for potential multi-character commands
-                if (c >= 32 && c < 127) { // Printable ASCII
-                    serialBuffer += c;
-                }
-                break;
-        }
     }
     
-    // Clear buffer if no input for a while
-    if (serialBuffer.length() > 0 && (millis() - lastSerialInput) > SERIAL_COMMAND_TIMEOUT_MS) {
-        serialBuffer = "";
-    }
-    
-    // Periodic status output (every 2 seconds)
-    static unsigned long lastStatusOutput = 0;
-    if (millis() - lastStatusOutput > 2000) {
-        Logger.printf("📊 Status - Speed: %.1f%%/%.1f%% (target/current), Dir: %s, Velocity: %.2f, Enabled: %s, Firing: %s\n",
-            getTargetSpeedPercent(),
-            getCurrentSpeedPercent(),
-            getCurrentDirection() ? "FORWARD" : "REVERSE",
-            getApproximateVelocity(),
-            isEnabled() ? "YES" : "NO",
-            isFiringThrusters() ? "YES" : "NO"
-        );
-        lastStatusOutput = millis();
+    // Complete a pending multi-character command (e.g. "S50") if no input for a while
+    if (serialParser.hasPending() && (millis() - lastSerialInput) > SERIAL_COMMAND_TIMEOUT_MS) {
+        serialParser.flush();
     }
 }
-
@@ -0,0 +1,144 @@
+#include "speed_pot.h"
+#include "config.h"
+#include "logging.h"
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+#define SPEED_POT_DMA_FRAME_BYTES 128      // Bytes per DMA interrupt (64 conversions)
+#define SPEED_POT_DMA_POOL_BYTES 1024      // Driver ring buffer size
+#define SPEED_POT_READ_BYTES 256           // Bytes pulled from the pool per read call
+
+static adc1_channel_t potChannel;
+static esp_adc_cal_characteristics_t adcChars;
+static bool dmaRunning = false;
+
+static uint8_t readBuffer[SPEED_POT_READ_BYTES];
+static uint32_t frameHistory[3];           // Last three oversampled frames (for the median)
+static uint8_t frameIndex = 0;
+static uint8_t framesSeen = 0;
+static float filteredMv = 0.0f;
+static bool filterPrimed = false;
+static float reportedPercent = -1.0f;      // < 0 forces the first report
+
+static SpeedPotStats stats = {};
+
+static uint32_t median3(uint32_t a, uint32_t b, uint32_t c) {
+    if (a > b) { uint32_t t = a; a = b; b = t; }
+    if (b > c) { b = c; }
+    return (a > b) ? a : b;
+}
+
+void initSpeedPot() {
+    potChannel = (adc1_channel_t)digitalPinToAnalogChannel(PIN_SPEED_POT);
+
+    // Use the factory eFuse characterisation (two-point or Vref) when available
+    esp_adc_cal_value_t calType = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adcChars);
+    stats.calibration = (calType == ESP_ADC_CAL_VAL_EFUSE_TP) ? "eFuse two-point" :
+                        (calType == ESP_ADC_CAL_VAL_EFUSE_VREF) ? "eFuse Vref" : "default Vref";
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = SPEED_POT_DMA_POOL_BYTES;
+    initConfig.conv_num_each_intr = SPEED_POT_DMA_FRAME_BYTES;
+    initConfig.adc1_chan_mask = BIT(potChannel);
+    initConfig.adc2_chan_mask = 0;
+
+    if (adc_digi_initialize(&initConfig) != ESP_OK) {
+        LOG_ERROR("❌ Speed pot ADC DMA initialization failed");
+        return;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = potChannel;
+    pattern.unit = 0; // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = 1;
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = 1;
+    digiConfig.adc_pattern = &pattern;
+    digiConfig.sample_freq_hz = SPEED_POT_SAMPLE_RATE_HZ;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&digiConfig) != ESP_OK || adc_digi_start() != ESP_OK) {
+        LOG_ERROR("❌ Speed pot ADC DMA start failed");
+        adc_digi_deinitialize();
+        return;
+    }
+
+    dmaRunning = true;
+    LOG_INFO("✅ Speed pot sampling at %d Hz via DMA (calibration: %s)", SPEED_POT_SAMPLE_RATE_HZ, stats.calibration);
+}
+
+bool readSpeedPot(float& percent, bool force) {
+    if (!dmaRunning) return false;
+
+    // Oversample: average every conversion that arrived since the last tick
+    uint32_t sum = 0;
+    uint32_t count = 0;
+    for (int reads = 0; reads < 4; reads++) {
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(readBuffer, SPEED_POT_READ_BYTES, &length, 0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            stats.overruns++;
+        } else if (err != ESP_OK) {
+            break; // ESP_ERR_TIMEOUT: nothing pending
+        }
+
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t* sample = (adc_digi_output_data_t*)&readBuffer[i];
+            if (sample->type1.channel == potChannel) {
+                sum += sample->type1.data;
+                count++;
+            }
+        }
+        if (length < SPEED_POT_READ_BYTES) break;
+    }
+
+    if (count > 0) {
+        stats.samples += count;
+        stats.lastRaw = (uint16_t)(sum / count);
+
+        // Median of the last three frames rejects single-frame spikes
+        frameHistory[frameIndex] = stats.lastRaw;
+        frameIndex = (frameIndex + 1) % 3;
+        if (framesSeen < 3) framesSeen++;
+        uint32_t raw = (framesSeen < 3) ? stats.lastRaw
+                       : median3(frameHistory[0], frameHistory[1], frameHistory[2]);
+
+        // IIR low-pass on the calibrated voltage
+        float mv = (float)esp_adc_cal_raw_to_voltage(raw, &adcChars);
+        if (!filterPrimed) {
+            filteredMv = mv;
+            filterPrimed = true;
+        } else {
+            filteredMv += (mv - filteredMv) / (float)(1 << SPEED_POT_FILTER_SHIFT);
+        }
+        stats.millivolts = (uint32_t)filteredMv;
+    }
+
+    if (!filterPrimed) return false;
+
+    float value = (filteredMv - SPEED_POT_MIN_MV) / (float)(SPEED_POT_MAX_MV - SPEED_POT_MIN_MV) * MAX_MOTOR_SPEED;
+    value = constrain(value, 0.0f, MAX_MOTOR_SPEED);
+
+    // Hysteresis deadband: only report movement larger than SPEED_POT_DEADBAND,
+    // but always let the end stops through so 0% and 100% are reachable
+    bool atEndStop = (value == 0.0f || value == MAX_MOTOR_SPEED) && value != reportedPercent;
+    if (!force && !atEndStop && reportedPercent >= 0.0f && fabsf(value - reportedPercent) < SPEED_POT_DEADBAND) {
+        return false;
+    }
+
+    reportedPercent = value;
+    stats.percent = value;
+    stats.updates++;
+    percent = value;
+    return true;
+}
+
+SpeedPotStats getSpeedPotStats() {
+    return stats;
+}
@@ -0,0 +1,226 @@
+#include "telemetry.h"
+#include "rocket_state.h"
+#include "seqlock.h"
+#include "logging.h"
+#include <Arduino.h>
+#include <atomic>
+
+static SeqLock<TelemetryFrame> publishedFrame;
+// Control task only
+static uint32_t encodedVersion = 0;
+static TelemetryFrame encodedFrame = {};
+
+// What a subscriber slot is bound to. Replaced as a whole through a seqlock, so
+// the dispatcher never pairs one subscription's callback with another's context.
+struct TelemetryBinding {
+    const char* name;
+    TelemetrySubscription config;
+    TelemetryCallback callback;
+    void* context;
+    uint32_t generation;        // +1 each time the slot is claimed
+};
+
+struct TelemetrySubscriber {
+    std::atomic<bool> active;
+    std::atomic<bool> requested;
+    SeqLock<TelemetryBinding> binding;  // Written under subscriberMux
+    uint32_t generation;                // subscriberMux
+    // Dispatch (comms) task only
+    uint32_t boundGeneration;   // Binding the state below belongs to
+    bool primed;                // First frame sent
+    bool pending;               // Relevant change waiting for minIntervalMs
+    TelemetryFrame lastSent;
+    uint32_t lastSentMs;
+};
+
+static TelemetrySubscriber subscribers[TELEMETRY_MAX_SUBSCRIBERS];
+static portMUX_TYPE subscriberMux = portMUX_INITIALIZER_UNLOCKED;   // Slot claims
+static std::atomic<bool> hubDirty(false);   // Subscriber added or push requested
+
+// Dispatch task only
+static TelemetryFrame dispatchedFrame = {};
+static bool hasDeadline = false;
+static uint32_t nextDeadlineMs = 0;
+
+// Fixed point with rounding, clamped to the field range
+static uint16_t toFixed(float value, float scale) {
+    float scaled = value * scale + 0.5f;
+    if (scaled <= 0.0f) return 0;
+    if (scaled >= 65535.0f) return 65535;
+    return (uint16_t)scaled;
+}
+
+// Same flags and fixed-point values (seq and timestamp aside)
+static bool sameFrameFields(const TelemetryFrame& a, const TelemetryFrame& b) {
+    return a.version == b.version && a.flags == b.flags && a.currentSpeed == b.currentSpeed &&
+           a.targetSpeed == b.targetSpeed && a.velocity == b.velocity;
+}
+
+void updateTelemetry() {
+    RocketStateSnapshot state = getRocketStateSnapshot();
+    if (state.version == encodedVersion) return;
+    encodedVersion = state.version;
+
+    TelemetryFrame frame;
+    frame.version = TELEMETRY_FRAME_VERSION;
+    frame.flags = (state.currentDirection ? TELEMETRY_FORWARD : 0) |
+                  (state.targetDirection ? TELEMETRY_TARGET_FORWARD : 0) |
+                  (state.enabled ? TELEMETRY_ENABLED : 0) |
+                  (state.isActive() ? TELEMETRY_ACTIVE : 0) |
+                  (state.firingThrusters ? TELEMETRY_FIRING : 0) |
+                  (state.emergencyStop ? TELEMETRY_EMERGENCY_STOP : 0);
+    frame.timestampMs = state.changedAtMs;
+    frame.currentSpeed = toFixed(state.currentSpeed, 10.0f);
+    frame.targetSpeed = toFixed(state.targetSpeed, 10.0f);
+    frame.velocity = toFixed(state.approximateVelocity, 100.0f);
+
+    // A new state version is not necessarily a new frame: only what the frame
+    // carries, at its resolution, counts as a change
+    if (sameFrameFields(frame, encodedFrame)) return;
+    frame.seq = encodedFrame.seq + 1;
+
+    publishedFrame.write(frame);
+    encodedFrame = frame;
+}
+
+TelemetryFrame getTelemetryFrame() {
+    return publishedFrame.read();
+}
+
+size_t formatTelemetryText(const TelemetryFrame& frame, char* buffer, size_t size) {
+    int length = snprintf(buffer, size,
+        "Speed: %u.%u%%/%u.%u%% (current/target), Dir: %s, Velocity: %u.%02u, Enabled: %s, Firing: %s%s",
+        frame.currentSpeed / 10, frame.currentSpeed % 10,
+        frame.targetSpeed / 10, frame.targetSpeed % 10,
+        (frame.flags & TELEMETRY_FORWARD) ? "FWD" : "REV",
+        frame.velocity / 100, frame.velocity % 100,
+        (frame.flags & TELEMETRY_ACTIVE) ? "YES" : "NO",
+        (frame.flags & TELEMETRY_FIRING) ? "YES" : "NO",
+        (frame.flags & TELEMETRY_EMERGENCY_STOP) ? ", EMERGENCY STOP" : "");
+    if (length < 0) return 0;
+    return min((size_t)length, size - 1);
+}
+
+int subscribeTelemetry(const char* name, const TelemetrySubscription& subscription,
+                       TelemetryCallback callback, void* context) {
+    int id = -1;
+    portENTER_CRITICAL(&subscriberMux);
+    for (int i = 0; i < TELEMETRY_MAX_SUBSCRIBERS; i++) {
+        TelemetrySubscriber& subscriber = subscribers[i];
+        if (subscriber.active.load(std::memory_order_relaxed)) continue;
+        // Cleared while the binding changes; set with release once it is complete.
+        // A dispatch already past the flag reads either binding whole, and the
+        // new generation tells it to start the new subscriber afresh.
+        subscriber.active.store(false, std::memory_order_relaxed);
+        subscriber.binding.write({ name, subscription, callback, context, ++subscriber.generation });
+        subscriber.requested.store(false, std::memory_order_relaxed);
+        subscriber.active.store(true, std::memory_order_release);
+        id = i;
+        break;
+    }
+    portEXIT_CRITICAL(&subscriberMux);
+
+    if (id < 0) {
+        LOG_WARN("⚠️ Telemetry: no free subscriber slot for %s", name);
+        return -1;
+    }
+    hubDirty.store(true, std::memory_order_release);
+    LOG_DEBUG("📡 Telemetry subscriber %d: %s (min %u ms, heartbeat %u ms)",
+        id, name, subscription.minIntervalMs, subscription.heartbeatMs);
+    return id;
+}
+
+void unsubscribeTelemetry(int id) {
+    if (id < 0 || id >= TELEMETRY_MAX_SUBSCRIBERS) return;
+    subscribers[id].active.store(false, std::memory_order_release);
+}
+
+void requestTelemetry(int id) {
+    if (id < 0 || id >= TELEMETRY_MAX_SUBSCRIBERS) return;
+    subscribers[id].requested.store(true, std::memory_order_relaxed);
+    hubDirty.store(true, std::memory_order_release);
+}
+
+static uint16_t absDiff(uint16_t a, uint16_t b) {
+    return (a > b) ? a - b : b - a;
+}
+
+// Does this frame differ from what the subscriber last got, in a way it cares about?
+static bool isRelevant(const TelemetrySubscription& config, const TelemetryFrame& frame, const TelemetryFrame& last) {
+    if ((config.fieldMask & TELEMETRY_FIELD_FLAGS) && frame.flags != last.flags) {
+        return true;
+    }
+    if ((config.fieldMask & TELEMETRY_FIELD_TARGET_SPEED) && frame.targetSpeed != last.targetSpeed) {
+        return true;
+    }
+    if (config.fieldMask & TELEMETRY_FIELD_CURRENT_SPEED) {
+        if (absDiff(frame.currentSpeed, last.currentSpeed) >= max<uint16_t>(config.speedDeadband, 1)) return true;
+        // Always report where the ramp settled, even inside the deadband
+        if (frame.currentSpeed == frame.targetSpeed && last.currentSpeed != frame.currentSpeed) return true;
+    }
+    if (config.fieldMask & TELEMETRY_FIELD_VELOCITY) {
+        if (absDiff(frame.velocity, last.velocity) >= max<uint16_t>(config.velocityDeadband, 1)) return true;
+        if (frame.velocity == 0 && last.velocity != 0) return true;
+    }
+    return false;
+}
+
+void dispatchTelemetry() {
+    uint32_t now = millis();
+    bool dirty = hubDirty.exchange(false, std::memory_order_acquire);
+    TelemetryFrame frame = getTelemetryFrame();
+    if (frame.version == 0) return;     // Nothing encoded yet
+
+    // Cost scales with changes: an idle tick is one seqlock read and a compare
+    // of the frame fields (not seq, which wraps)
+    bool changed = !sameFrameFields(frame, dispatchedFrame);
+    if (!changed && !dirty && !(hasDeadline && (int32_t)(now - nextDeadlineMs) >= 0)) {
+        return;
+    }
+    dispatchedFrame = frame;
+    hasDeadline = false;
+
+    for (int i = 0; i < TELEMETRY_MAX_SUBSCRIBERS; i++) {
+        TelemetrySubscriber& subscriber = subscribers[i];
+        if (!subscriber.active.load(std::memory_order_acquire)) continue;
+        TelemetryBinding binding = subscriber.binding.read();
+        const TelemetrySubscription& config = binding.config;
+        if (binding.generation != subscriber.boundGeneration) {
+            subscriber.boundGeneration = binding.generation;
+            subscriber.primed = false;
+            subscriber.pending = false;
+        }
+
+        bool due = subscriber.requested.exchange(false, std::memory_order_relaxed) || !subscriber.primed;
+        if (!due) {
+            if (changed && isRelevant(config, frame, subscriber.lastSent)) {
+                subscriber.pending = true;
+            }
+            uint32_t sinceLast = now - subscriber.lastSentMs;
+            due = (subscriber.pending && sinceLast >= config.minIntervalMs) ||
+                  (config.heartbeatMs > 0 && sinceLast >= config.heartbeatMs);
+        }
+
+        if (due) {
+            binding.callback(frame, binding.context);
+            subscriber.lastSent = frame;
+            subscriber.lastSentMs = now;
+            subscriber.pending = false;
+            subscriber.primed = true;
+        }
+
+        // Earliest time this subscriber needs another look without a new frame
+        uint32_t deadline;
+        if (subscriber.pending) {
+            deadline = subscriber.lastSentMs + config.minIntervalMs;
+        } else if (config.heartbeatMs > 0) {
+            deadline = subscriber.lastSentMs + config.heartbeatMs;
+        } else {
+            continue;
+        }
+        if (!hasDeadline || (int32_t)(deadline - nextDeadlineMs) < 0) {
+            nextDeadlineMs = deadline;
+            hasDeadline = true;
+        }
+    }
+}
@@ -0,0 +1,209 @@
+#include "udp_control.h"
+#include "config.h"
+#include "command_bus.h"
+#include "rocket_state.h"
+#include "logging.h"
+#include <Arduino.h>
+#include <AsyncUDP.h>
+
+struct UdpClient {
+    bool active;
+    IPAddress ip;
+    uint16_t port;
+    uint32_t clientId;
+    uint32_t lastSeq;
+    uint32_t lastClientTimeMs;
+    uint32_t lastReceivedMs;
+    uint32_t lastAcceptedMs;
+    bool engaged;               // Last setpoint asked for speed or thrust
+    // Last values forwarded to the command bus (repeats are not re-applied)
+    bool applied;
+    uint16_t speedTenths;
+    uint8_t flags;
+};
+
+static AsyncUDP udp;
+static bool udpStarted = false;
+
+// Written by the AsyncUDP task, read by the network task
+static portMUX_TYPE udpMux = portMUX_INITIALIZER_UNLOCKED;
+static UdpClient clients[UDP_MAX_CLIENTS];
+static UdpControlStats stats = {};
+
+static uint16_t toTenths(float percent) {
+    return (uint16_t)constrain(percent * 10.0f + 0.5f, 0.0f, 1000.0f);
+}
+
+// Finds the client's slot, or takes a free one / the least recently heard idle
+// one. An engaged client keeps its slot until it times out (and gets its
+// failsafe stop), so a newcomer is refused while every slot is engaged (udpMux held)
+static UdpClient* findClient(uint32_t clientId, const IPAddress& ip, uint16_t port, uint32_t nowMs) {
+    UdpClient* oldest = nullptr;
+    for (int i = 0; i < UDP_MAX_CLIENTS; i++) {
+        UdpClient& client = clients[i];
+        if (client.active && client.clientId == clientId) {
+            return &client;
+        }
+        if (client.active && client.engaged) continue;
+        if (!oldest || (oldest->active && (!client.active || (int32_t)(client.lastReceivedMs - oldest->lastReceivedMs) < 0))) {
+            oldest = &client;
+        }
+    }
+    if (!oldest) return nullptr;
+    *oldest = {};
+    oldest->active = true;
+    oldest->clientId = clientId;
+    oldest->ip = ip;
+    oldest->port = port;
+    oldest->lastReceivedMs = nowMs;
+    return oldest;
+}
+
+// AsyncUDP task
+static void onPacket(AsyncUDPPacket& packet) {
+    UdpSetpointPacket in;
+    if (packet.length() != sizeof(in)) {
+        portENTER_CRITICAL(&udpMux);
+        stats.malformed++;
+        portEXIT_CRITICAL(&udpMux);
+        return;
+    }
+    memcpy(&in, packet.data(), sizeof(in));
+    if (in.magic != UDP_PACKET_MAGIC || in.version != UDP_PACKET_VERSION || in.type != UDP_PACKET_SETPOINT) {
+        portENTER_CRITICAL(&udpMux);
+        stats.malformed++;
+        portEXIT_CRITICAL(&udpMux);
+        return;
+    }
+
+    uint32_t nowMs = millis();
+    Setpoint setpoint = {};
+    setpoint.clientId = in.clientId;
+    setpoint.seq = in.seq;
+    setpoint.clientTimeMs = in.clientTimeMs;
+    setpoint.speed = min<uint16_t>(in.speedTenths, 1000) / 10.0f;
+    setpoint.forward = in.flags & UDP_SETPOINT_FORWARD;
+    setpoint.fire = in.flags & UDP_SETPOINT_FIRE;
+
+    portENTER_CRITICAL(&udpMux);
+    UdpClient* slot = findClient(in.clientId, packet.remoteIP(), packet.remotePort(), nowMs);
+    if (!slot) {
+        stats.refused++;
+        portEXIT_CRITICAL(&udpMux);
+        return;
+    }
+    UdpClient& client = *slot;
+    // Only forward what changed since the last accepted datagram, so the
+    // heartbeat repeats don't re-apply (or re-log) the same setpoint
+    if (!client.applied || in.speedTenths != client.speedTenths) setpoint.fields |= SETPOINT_SPEED;
+    if (!client.applied || ((in.flags ^ client.flags) & UDP_SETPOINT_FORWARD)) setpoint.fields |= SETPOINT_DIRECTION;
+    if (!client.applied || ((in.flags ^ client.flags) & UDP_SETPOINT_FIRE)) setpoint.fields |= SETPOINT_FIRE;
+    portEXIT_CRITICAL(&udpMux);
+
+    bool accepted = postSetpoint(setpoint, SOURCE_UDP) == SETPOINT_ACCEPTED;
+
+    portENTER_CRITICAL(&udpMux);
+    // The slot may have been recycled meanwhile; only update it if it is still ours
+    if (client.active && client.clientId == in.clientId) {
+        client.lastReceivedMs = nowMs;
+        client.ip = packet.remoteIP();      // Follow a client whose address changed
+        client.port = packet.remotePort();
+        if (accepted) {
+            client.applied = true;
+            client.lastSeq = in.seq;
+            client.lastClientTimeMs = in.clientTimeMs;
+            client.lastAcceptedMs = nowMs;
+            client.speedTenths = in.speedTenths;
+            client.flags = in.flags;
+            client.engaged = in.speedTenths > 0 || (in.flags & UDP_SETPOINT_FIRE);
+        }
+    }
+    if (accepted) {
+        stats.received++;
+    } else {
+        stats.stale++;
+    }
+    portEXIT_CRITICAL(&udpMux);
+}
+
+void initUdpControl() {
+    if (udpStarted) return;
+
+    if (!udp.listen(UDP_CONTROL_PORT)) {
+        LOG_ERROR("❌ UDP control failed to listen on port %d", UDP_CONTROL_PORT);
+        return;
+    }
+    udp.onPacket(onPacket);
+    udpStarted = true;
+    LOG_INFO("✅ UDP control listening on port %d", UDP_CONTROL_PORT);
+}
+
+void updateUdpControl() {
+    if (!udpStarted) return;
+
+    static unsigned long lastStateSend = 0;
+    uint32_t nowMs = millis();
+    bool sendState = nowMs - lastStateSend >= UDP_STATE_INTERVAL_MS;
+    if (sendState) {
+        lastStateSend = nowMs;
+    }
+
+    RocketStateSnapshot state = getRocketStateSnapshot();
+    UdpStatePacket out = {};
+    out.magic = UDP_PACKET_MAGIC;
+    out.version = UDP_PACKET_VERSION;
+    out.type = UDP_PACKET_STATE;
+    out.stateVersion = state.version;
+    out.uptimeMs = nowMs;
+    out.currentSpeedTenths = toTenths(state.currentSpeed);
+    out.targetSpeedTenths = toTenths(state.targetSpeed);
+    out.flags = (state.currentDirection ? UDP_STATE_FORWARD : 0) |
+                (state.targetDirection ? UDP_STATE_TARGET_FORWARD : 0) |
+                (state.enabled ? UDP_STATE_ENABLED : 0) |
+                (state.firingThrusters ? UDP_STATE_FIRING : 0) |
+                (state.emergencyStop ? UDP_STATE_EMERGENCY_STOP : 0);
+
+    for (int i = 0; i < UDP_MAX_CLIENTS; i++) {
+        UdpClient client;
+        bool timedOut = false;
+
+        portENTER_CRITICAL(&udpMux);
+        client = clients[i];
+        if (client.active && nowMs - client.lastReceivedMs > UDP_CONTROL_TIMEOUT_MS) {
+            clients[i].active = false;
+            timedOut = true;
+            if (client.engaged) stats.failsafes++;
+        }
+        portEXIT_CRITICAL(&udpMux);
+
+        if (timedOut) {
+            if (client.engaged) {
+                LOG_WARN("⚠️ UDP client %s went silent - stopping", client.ip.toString().c_str());
+                postCommand(CMD_SET_SPEED, SOURCE_UDP, 0.0f);
+                postCommand(CMD_FIRE, SOURCE_UDP, 0.0f);
+            }
+            continue;
+        }
+        if (!client.active || !sendState) continue;
+
+        out.ackSeq = client.lastSeq;
+        out.echoTimeMs = client.lastClientTimeMs;
+        out.echoAgeMs = min<uint32_t>(nowMs - client.lastAcceptedMs, 0xFFFF);
+        if (udp.writeTo((const uint8_t*)&out, sizeof(out), client.ip, client.port) == sizeof(out)) {
+            portENTER_CRITICAL(&udpMux);
+            stats.sent++;
+            portEXIT_CRITICAL(&udpMux);
+        }
+    }
+}
+
+UdpControlStats getUdpControlStats() {
+    portENTER_CRITICAL(&udpMux);
+    UdpControlStats copy = stats;
+    copy.clients = 0;
+    for (int i = 0; i < UDP_MAX_CLIENTS; i++) {
+        if (clients[i].active) copy.clients++;
+    }
+    portEXIT_CRITICAL(&udpMux);
+    return copy;
+}
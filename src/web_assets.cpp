@@ -0,0 +1,10 @@
+#include "web_assets.h"
+#include "web_assets_data.h"    // Generated before each build (gitignored)
+
+int getWebAssetCount() {
+    return sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
+}
+
+const WebAsset& getWebAsset(int index) {
+    return WEB_ASSETS[index];
+}
@@ -2,15 +2,149 @@
 #include "config.h"
 #include "rocket_state.h"
 #include "logging.h"
+#include "rtos_tasks.h"
+#include "command_bus.h"
+#include "command_parser.h"
+#include "physical_inputs.h"
+#include "speed_pot.h"
+#include "seqlock.h"
+#include "web_assets.h"
+#include "udp_control.h"
+#include "telemetry.h"
+#include "ble_interface.h"
+#include "radio_profile.h"
+#include "wifi_manager.h"
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include <memory>
+#include <atomic>
 
-extern bool isConfigMode;
 AsyncWebServer server(WEB_SERVER_PORT);
+AsyncWebSocket ws("/ws");
 
-// WiFi config portal handlers (only used in config mode)
-void handleWiFiConfigRoot(AsyncWebServerRequest *request) {
-    const char* html = R"(
+static bool webInterfaceStarted = false;
+static std::atomic<bool> wsPushPending(false);     // Set by the telemetry hub
+
+// State JSON, rendered once per state version by the network task and shared by
+// /api/state and /ws. Readers on the AsyncTCP task copy it out through the seqlock.
+struct StateJson {
+    uint32_t version;
+    uint16_t length;
+    char text[STATE_JSON_MAX_LENGTH];
+};
+
+static SeqLock<StateJson> stateJson;
+static uint32_t renderedVersion = 0;
+static StateJson renderBuffer;          // Network task only
+static uint32_t bootNonce = 0;          // ETag prefix, so a version from a previous boot never matches
+
+// Re-render only when the published state changed; returns true if it did
+static bool refreshStateJson() {
+    RocketStateSnapshot state = getRocketStateSnapshot();
+    if (state.version == renderedVersion && stateJson.writeCount() > 0) {
+        return false;
+    }
+
+    JsonDocument doc;
+    doc["currentSpeed"] = state.currentSpeed;
+    doc["targetSpeed"] = state.targetSpeed;
+    doc["direction"] = state.currentDirection;
+    doc["targetDirection"] = state.targetDirection;
+    doc["velocity"] = state.approximateVelocity;
+    doc["enabled"] = state.isActive();
+    doc["firingThrusters"] = state.firingThrusters;
+    doc["version"] = state.version;
+    doc["timestamp"] = state.changedAtMs;
+
+    renderBuffer.version = state.version;
+    renderBuffer.length = serializeJson(doc, renderBuffer.text, sizeof(renderBuffer.text));
+    stateJson.write(renderBuffer);
+    renderedVersion = state.version;
+    return true;
+}
+
+// Chunked response rendered from the log ring as the TCP window allows
+static void sendLogStream(AsyncWebServerRequest *request, LogStreamFormat format, uint32_t since = 0) {
+    std::shared_ptr<LogStreamRenderer> renderer = std::make_shared<LogStreamRenderer>(format, since);
+    const char* contentType = (format == LOG_STREAM_HTML) ? "text/html" : "application/json";
+    AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+        [renderer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return renderer->read(buffer, maxLen);
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+// Serves a gzipped asset straight from flash; a matching If-None-Match gets a 304
+static void sendWebAsset(AsyncWebServerRequest *request, const WebAsset& asset) {
+    AsyncWebServerResponse *response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == asset.etag) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", asset.cacheControl);
+    request->send(response);
+}
+
+static void sendLogLevel(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["level"] = Logger.getLevel();
+    doc["name"] = LoggerClass::getLevelName(Logger.getLevel());
+    doc["compiledLevel"] = LOG_LOCAL_LEVEL;
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// Telemetry hub (comms task): the network task does the actual push
+static void onWebSocketTelemetry(const TelemetryFrame& frame, void* context) {
+    wsPushPending.store(true, std::memory_order_release);
+}
+
+static void sendStateTo(AsyncWebSocketClient *client) {
+    StateJson json = stateJson.read();
+    client->text(json.text, json.length);
+}
+
+static void handleWebSocketCommand(const ParsedCommand& cmd, void* context) {
+    AsyncWebSocketClient *client = static_cast<AsyncWebSocketClient*>(context);
+    if (cmd.op == '?') {
+        sendStateTo(client);
+    } else if (!postParsedCommand(cmd, SOURCE_WEB)) {
+        client->text(cmd.op == 'P' ? "{\"error\":\"Unknown radio profile\"}" : "{\"error\":\"Command queue full\"}");
+    }
+}
+
+static void onWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type,
+                             void *arg, uint8_t *data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+        LOG_DEBUG("🔌 WebSocket client #%lu connected", (unsigned long)client->id());
+        sendStateTo(client);
+    } else if (type == WS_EVT_DISCONNECT) {
+        LOG_DEBUG("🔌 WebSocket client #%lu disconnected", (unsigned long)client->id());
+    } else if (type == WS_EVT_DATA) {
+        // Commands are short: only whole, unfragmented text frames are accepted
+        AwsFrameInfo *info = static_cast<AwsFrameInfo*>(arg);
+        if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
+            CommandParser parser(handleWebSocketCommand, client);
+            parser.feed((const char*)data, len);
+            parser.flush();
+        }
+    }
+}
+
+// WiFi setup page: "/" for setup access point clients until the station is
+// connected, "/wifi" from anywhere
+static bool isSetupClient(AsyncWebServerRequest *request) {
+    return ON_AP_FILTER(request) && getWiFiStats().state != WIFI_STATE_CONNECTED;
+}
+
+static void handleWiFiConfigRoot(AsyncWebServerRequest *request) {
+    const char* head = R"(
 <!DOCTYPE html><html><head><title>WiFi Setup</title>
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <style>body{font-family:Arial;margin:20px;background:#f0f0f0}
@@ -19,6 +153,8 @@ input{width:100%;padding:8px;margin:5px 0;border:1px solid #ddd;box-sizing:borde
 button{width:100%;background:#007cba;color:white;padding:10px;border:none;cursor:pointer;margin:5px 0}
 .logs-btn{background:#28a745;text-decoration:none;display:block;text-align:center;padding:10px;color:white;border-radius:5px}
 </style></head><body><div class="c"><h2>📡 WiFi Config</h2>
+)";
+    const char* form = R"(
 <form action="/wifi-save" method="POST">
 <input type="text" name="ssid" placeholder="WiFi SSID" required>
 <input type="password" name="password" placeholder="Password">
@@ -26,344 +162,464 @@ button{width:100%;background:#007cba;color:white;padding:10px;border:none;cursor
 <a href="/logs" class="logs-btn">📄 View System Logs</a>
 </div></body></html>
 )";
+    WiFiStats stats = getWiFiStats();
+    String html = head;
+    html += "<p>Status: ";
+    html += getWiFiStateName(stats.state);
+    if (stats.state == WIFI_STATE_CONNECTED) {
+        html += " to " + WiFi.SSID() + " (" + WiFi.localIP().toString() + ")";
+    }
+    html += "</p>";
+    html += form;
     request->send(200, "text/html", html);
 }
 
-void handleWiFiConfigSave(AsyncWebServerRequest *request) {
+static void handleWiFiConfigSave(AsyncWebServerRequest *request) {
     if (request->hasParam("ssid", true)) {
         String ssid = request->getParam("ssid", true)->value();
         String password = request->hasParam("password", true) ? request->getParam("password", true)->value() : "";
         
-        // Save credentials (defined in wifi_manager.cpp)
-        extern void saveWiFiCredentials(const String& ssid, const String& password);
+        // The WiFi state machine picks these up on its next step
         saveWiFiCredentials(ssid, password);
         
-        request->send(200, "text/plain", "Connecting to " + ssid + "...\nDevice will restart.");
-        delay(1000);
-        ESP.restart();
+        request->send(200, "text/plain", "Connecting to " + ssid + "...\n"
+            "The setup network stays up until the device has joined; see /wifi for the status.");
     } else {
         request->send(400, "text/plain", "SSID required");
     }
 }
 
-void initConfigPortalWebInterface() {
-    server.on("/", HTTP_GET, handleWiFiConfigRoot);
+// Called when the setup access point or the station comes up, whichever is first
+void initWebInterface() {
+    if (webInterfaceStarted) return;
+    bootNonce = esp_random();
+    
+    // WiFi setup (registered before the assets so it wins "/" for setup clients)
+    server.on("/", HTTP_GET, handleWiFiConfigRoot).setFilter(isSetupClient);
+    server.on("/wifi", HTTP_GET, handleWiFiConfigRoot);
     server.on("/wifi-save", HTTP_POST, handleWiFiConfigSave);
-    server.on("/logs", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", Logger.getLogsAsHtml());
-    });
+    // Captive portal: any unknown URL leads setup clients to the setup page
     server.onNotFound([](AsyncWebServerRequest *request) {
-        request->redirect("/");
+        if (isSetupClient(request)) {
+            request->redirect("/");
+        } else {
+            request->send(404, "text/plain", "Not found");
+        }
     });
-    server.begin();
-    Logger.println("✅ WiFi config portal web interface initialized");
-}
-
-void initWebInterface() {
-    // Only initialize main interface if not in config mode
-    if (isConfigMode) {
-        initConfigPortalWebInterface();
-        return;
+    
+    // Static UI (gzipped into flash at build time, see tools/embed_web_assets.py)
+    for (int i = 0; i < getWebAssetCount(); i++) {
+        const WebAsset& asset = getWebAsset(i);
+        server.on(asset.path, HTTP_GET, [&asset](AsyncWebServerRequest *request) {
+            sendWebAsset(request, asset);
+        });
     }
+    server.on("/app", HTTP_GET, [](AsyncWebServerRequest *request) {
+        request->redirect("/app/");
+    });
     
-    // Root page - main control interface
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        String html = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>Space Tornado Control</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <meta charset="UTF-8">
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            margin: 0;
-            padding: 20px;
-            background: #1a1a1a;
-            color: #fff;
-        }
-        .container {
-            max-width: 800px;
-            margin: 0 auto;
-        }
-        .header {
-            text-align: center;
-            margin-bottom: 30px;
-        }
-        .status-card {
-            background: #2a2a2a;
-            border-radius: 10px;
-            padding: 20px;
-            margin-bottom: 20px;
-        }
-        .status-item {
-            display: flex;
-            justify-content: space-between;
-            margin: 10px 0;
-            padding: 10px;
-            background: #1a1a1a;
-            border-radius: 5px;
-        }
-        .control-section {
-            background: #2a2a2a;
-            border-radius: 10px;
-            padding: 20px;
-            margin-bottom: 20px;
+    // API endpoint for state: cached JSON, ETag = state version (304 when unchanged)
+    refreshStateJson();
+    server.on("/api/state", HTTP_GET, [](AsyncWebServerRequest *request) {
+        // Per-request copy: the response outlives the seqlock read and may be sent in pieces
+        std::shared_ptr<StateJson> json = std::make_shared<StateJson>(stateJson.read());
+        char etag[32];
+        snprintf(etag, sizeof(etag), "\"%08lx-v%lu\"", (unsigned long)bootNonce, (unsigned long)json->version);
+
+        AsyncWebServerResponse *response;
+        if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+            response = request->beginResponse(304);
+        } else {
+            response = request->beginResponse("application/json", json->length,
+                [json](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                    size_t count = min(maxLen, (size_t)json->length - index);
+                    memcpy(buffer, json->text + index, count);
+                    return count;
+                });
         }
-        .slider-container {
-            margin: 20px 0;
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+    });
+
+    // Binary TelemetryFrame (same bytes as the BLE status notification)
+    server.on("/api/telemetry", HTTP_GET, [](AsyncWebServerRequest *request) {
+        TelemetryFrame frame = getTelemetryFrame();
+        AsyncResponseStream *response = request->beginResponseStream("application/octet-stream");
+        response->write((const uint8_t*)&frame, sizeof(frame));     // Copied; frame is a local
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
+    });
+
+    // WebSocket: state pushed on change, text commands (shared grammar) from the client
+    ws.onEvent(onWebSocketEvent);
+    server.addHandler(&ws);
+    
+    // API endpoint for task timing (period, jitter, missed deadlines)
+    server.on("/api/tasks", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray tasks = doc["tasks"].to<JsonArray>();
+        for (int i = 0; i < getTaskCount(); i++) {
+            TaskTimingStats stats = getTaskStats(i);
+            JsonObject task = tasks.add<JsonObject>();
+            task["name"] = stats.name;
+            task["periodUs"] = stats.periodUs;
+            task["lastPeriodUs"] = stats.lastPeriodUs;
+            task["maxPeriodUs"] = stats.maxPeriodUs;
+            task["jitterUs"] = stats.lastJitterUs;
+            task["maxJitterUs"] = stats.maxJitterUs;
+            task["runUs"] = stats.lastRunUs;
+            task["maxRunUs"] = stats.maxRunUs;
+            task["missedDeadlines"] = stats.missedDeadlines;
+            task["iterations"] = stats.iterations;
         }
-        .slider {
-            width: 100%;
-            height: 30px;
-            -webkit-appearance: none;
-            appearance: none;
-            background: #444;
-            outline: none;
-            border-radius: 15px;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+
+    // Clear the task timing maximums and counters
+    server.on("/api/tasks/reset", HTTP_POST, [](AsyncWebServerRequest *request) {
+        resetTaskStats();
+        request->send(200, "text/plain", "Task statistics reset");
+    });
+    
+    // API endpoint for physical input debounce/latency and speed pot statistics
+    server.on("/api/inputs", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray inputs = doc["inputs"].to<JsonArray>();
+        for (int i = 0; i < getPhysicalInputCount(); i++) {
+            PhysicalInputStats stats = getPhysicalInputStats(i);
+            JsonObject input = inputs.add<JsonObject>();
+            input["name"] = stats.name;
+            input["level"] = stats.level ? 1 : 0;
+            input["edges"] = stats.edges;
+            input["changes"] = stats.changes;
+            input["latencyUs"] = stats.lastLatencyUs;
+            input["maxLatencyUs"] = stats.maxLatencyUs;
         }
-        .slider::-webkit-slider-thumb {
-            -webkit-appearance: none;
-            appearance: none;
-            width: 30px;
-            height: 30px;
-            background: #4CAF50;
-            cursor: pointer;
-            border-radius: 50%;
+        
+        SpeedPotStats pot = getSpeedPotStats();
+        JsonObject speedPot = doc["speedPot"].to<JsonObject>();
+        speedPot["calibration"] = pot.calibration;
+        speedPot["samples"] = pot.samples;
+        speedPot["overruns"] = pot.overruns;
+        speedPot["raw"] = pot.lastRaw;
+        speedPot["millivolts"] = pot.millivolts;
+        speedPot["percent"] = pot.percent;
+        speedPot["updates"] = pot.updates;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // API endpoint for command bus statistics (queue depth, latency)
+    server.on("/api/commands", HTTP_GET, [](AsyncWebServerRequest *request) {
+        CommandBusStats stats = getCommandBusStats();
+        JsonDocument doc;
+        JsonObject posted = doc["posted"].to<JsonObject>();
+        for (int i = 0; i < SOURCE_COUNT; i++) {
+            posted[getCommandSourceName((CommandSource)i)] = stats.posted[i];
         }
-        .slider::-moz-range-thumb {
-            width: 30px;
-            height: 30px;
-            background: #4CAF50;
-            cursor: pointer;
-            border-radius: 50%;
+        doc["applied"] = stats.applied;
+        doc["dropped"] = stats.dropped;
+        doc["depth"] = stats.depth;
+        doc["maxDepth"] = stats.maxDepth;
+        doc["latencyUs"] = stats.lastLatencyUs;
+        doc["avgLatencyUs"] = stats.avgLatencyUs;
+        doc["maxLatencyUs"] = stats.maxLatencyUs;
+        JsonObject setpoints = doc["setpoints"].to<JsonObject>();
+        setpoints["accepted"] = stats.setpointsAccepted;
+        setpoints["stale"] = stats.setpointsStale;
+        setpoints["applied"] = stats.setpointsApplied;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+
+    // Zero all command bus counters and maximums
+    server.on("/api/commands/reset", HTTP_POST, [](AsyncWebServerRequest *request) {
+        resetCommandBusStats();
+        request->send(200, "text/plain", "Command bus statistics reset");
+    });
+    
+    // UDP control channel counters
+    server.on("/api/udp", HTTP_GET, [](AsyncWebServerRequest *request) {
+        UdpControlStats stats = getUdpControlStats();
+        JsonDocument doc;
+        doc["port"] = UDP_CONTROL_PORT;
+        doc["clients"] = stats.clients;
+        doc["received"] = stats.received;
+        doc["malformed"] = stats.malformed;
+        doc["stale"] = stats.stale;
+        doc["sent"] = stats.sent;
+        doc["failsafes"] = stats.failsafes;
+        doc["refused"] = stats.refused;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // WiFi state machine and boot timing. stepMaxUs is the longest handleWiFiLoop() step; the
+    // task maxima show whether WiFi work ever held up the network or control task.
+    server.on("/api/wifi", HTTP_GET, [](AsyncWebServerRequest *request) {
+        WiFiStats stats = getWiFiStats();
+        JsonDocument doc;
+        doc["state"] = getWiFiStateName(stats.state);
+        if (stats.state == WIFI_STATE_CONNECTED) {
+            doc["ssid"] = WiFi.SSID();
+            doc["ip"] = WiFi.localIP().toString();
+            doc["rssi"] = WiFi.RSSI();
         }
-        .fire-button {
-            width: 100%;
-            height: 80px;
-            font-size: 32px;
-            background: #d32f2f;
-            color: white;
-            border: none;
-            border-radius: 10px;
-            cursor: pointer;
-            font-weight: bold;
+        doc["apActive"] = stats.apActive;
+        doc["apStations"] = stats.apStations;
+        doc["attempts"] = stats.attempts;
+        doc["connects"] = stats.connects;
+        doc["disconnects"] = stats.disconnects;
+        doc["lastDisconnectReason"] = stats.lastDisconnectReason;
+        doc["backoffMs"] = stats.backoffMs;
+        doc["fastConnect"] = stats.fastConnect;
+        doc["fastConnectFailures"] = stats.fastConnectFailures;
+        // Milliseconds after boot (0 = not reached yet)
+        JsonObject boot = doc["boot"].to<JsonObject>();
+        boot["connectedMs"] = stats.bootConnectedMs;
+        boot["webReadyMs"] = stats.bootWebReadyMs;
+        doc["stepLastUs"] = stats.lastStepUs;
+        doc["stepMaxUs"] = stats.maxStepUs;
+        for (int i = 0; i < getTaskCount(); i++) {
+            TaskTimingStats task = getTaskStats(i);
+            if (strcmp(task.name, "control") == 0) {
+                doc["controlMaxJitterUs"] = task.maxJitterUs;
+            } else if (strcmp(task.name, "network") == 0) {
+                doc["networkMaxRunUs"] = task.maxRunUs;
+            }
         }
-        .fire-button:active {
-            background: #b71c1c;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // BLE connections: negotiated parameters, notify backpressure, command-to-notify latency
+    server.on("/api/ble", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        JsonArray connections = doc["connections"].to<JsonArray>();
+        for (int i = 0; i < getBleConnectionCount(); i++) {
+            BleConnectionStats stats;
+            if (!getBleConnectionStats(i, stats)) continue;
+            JsonObject entry = connections.add<JsonObject>();
+            entry["handle"] = stats.connHandle;
+            entry["mtu"] = stats.mtu;
+            entry["intervalMs"] = stats.interval * 1.25f;
+            entry["slaveLatency"] = stats.latency;
+            entry["active"] = stats.activeParams;
+            entry["commands"] = stats.commands;
+            entry["binaryCommands"] = stats.binaryCommands;
+            entry["rejectedCommands"] = stats.rejectedCommands;
+            entry["notifies"] = stats.notifies;
+            entry["notifyFailures"] = stats.notifyFailures;
+            entry["notifySkipped"] = stats.notifySkipped;
+            JsonObject latency = entry["latencyUs"].to<JsonObject>();
+            latency["last"] = stats.lastLatencyUs;
+            latency["avg"] = stats.avgLatencyUs;
+            latency["max"] = stats.maxLatencyUs;
+            latency["samples"] = stats.latencySamples;
         }
-        .fire-button.firing {
-            background: #ff6f00;
-            animation: pulse 0.5s infinite;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    // API endpoint for the runtime log level (read-only; POST changes it)
+    server.on("/api/loglevel", HTTP_GET, [](AsyncWebServerRequest *request) {
+        sendLogLevel(request);
+    });
+
+    // Set the runtime level with level=0-5 or a level name
+    server.on("/api/loglevel", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (!request->hasParam("level")) {
+            request->send(400, "text/plain", "Missing level parameter");
+            return;
         }
-        @keyframes pulse {
-            0%, 100% { opacity: 1; }
-            50% { opacity: 0.7; }
+        String value = request->getParam("level")->value();
+        int level = -1;
+        if (value.length() > 0 && isDigit(value[0])) {
+            level = value.toInt();
+        } else {
+            for (int i = LOG_LEVEL_NONE; i <= LOG_LEVEL_TRACE; i++) {
+                if (value.equalsIgnoreCase(LoggerClass::getLevelName(i))) level = i;
+            }
         }
-        .value-display {
-            font-size: 24px;
-            font-weight: bold;
-            color: #4CAF50;
+        if (level < LOG_LEVEL_NONE || level > LOG_LEVEL_TRACE) {
+            request->send(400, "text/plain", "Invalid level");
+            return;
         }
-        .timestamp {
-            color: #888;
-            font-size: 12px;
+        Logger.setLevel(level);
+        LOG_INFO("📝 Log level set to %s by Web", LoggerClass::getLevelName(level));
+        sendLogLevel(request);
+    });
+
+    // Radio profile: which stacks run, and the numbers from each profile's last run (read-only)
+    server.on("/api/radio", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        doc["profile"] = getRadioProfile(getActiveRadioProfile()).name;
+        int pending = getPendingRadioProfile();
+        if (pending >= 0) {
+            doc["restartingInto"] = getRadioProfile(pending).name;
         }
-        a {
-            color: #4CAF50;
-            text-decoration: none;
-            margin: 0 10px;
+        JsonArray profiles = doc["profiles"].to<JsonArray>();
+        for (int i = 0; i < getRadioProfileCount(); i++) {
+            const RadioProfile& profile = getRadioProfile(i);
+            JsonObject entry = profiles.add<JsonObject>();
+            entry["index"] = i;
+            entry["name"] = profile.name;
+            entry["wifi"] = (profile.stacks & RADIO_WIFI) != 0;
+            entry["ble"] = (profile.stacks & RADIO_BLE) != 0;
+            entry["spp"] = (profile.stacks & RADIO_SPP) != 0;
+            RadioProfileMetrics metrics;
+            if (!getRadioProfileMetrics(i, metrics)) continue;
+            JsonObject run = entry["lastRun"].to<JsonObject>();
+            run["boots"] = metrics.boots;
+            run["uptimeS"] = metrics.uptimeS;
+            run["bootFreeHeap"] = metrics.bootFreeHeap;
+            run["freeHeap"] = metrics.freeHeap;
+            run["minFreeHeap"] = metrics.minFreeHeap;
+            run["largestFreeBlock"] = metrics.largestFreeBlock;
+            run["controlJitterMaxUs"] = metrics.controlJitterMaxUs;
+            run["commandLatencyMaxUs"] = metrics.commandLatencyMaxUs;
+            run["bleLatencyAvgUs"] = metrics.bleLatencyAvgUs;
         }
-        a:hover {
-            text-decoration: underline;
+
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+
+    // profile=<name or index> persists a new profile and restarts the device
+    server.on("/api/radio", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (!request->hasParam("profile")) {
+            request->send(400, "text/plain", "Missing profile parameter");
+            return;
         }
-        .firing-indicator {
-            display: none;
-            background: #ff6f00;
-            padding: 10px;
-            border-radius: 5px;
-            text-align: center;
-            animation: pulse 0.3s infinite;
+        String value = request->getParam("profile")->value();
+        int index = (value.length() > 0 && isDigit(value[0])) ? value.toInt() : findRadioProfile(value.c_str());
+        if (!setRadioProfile(index)) {
+            request->send(400, "text/plain", "Invalid profile");
+            return;
         }
-        .firing-indicator.active {
-            display: block;
+        request->send(200, "text/plain", String("Restarting into ") + getRadioProfile(index).name);
+    });
+
+    // API endpoint for log buffer and per-sink delivery statistics
+    server.on("/api/logstats", HTTP_GET, [](AsyncWebServerRequest *request) {
+        LogStats stats = Logger.getStats();
+        JsonDocument doc;
+        doc["records"] = stats.records;
+        doc["bytesUsed"] = stats.bytesUsed;
+        doc["written"] = stats.written;
+        doc["evicted"] = stats.evicted;
+        doc["truncated"] = stats.truncated;
+        JsonArray sinks = doc["sinks"].to<JsonArray>();
+        for (int i = 0; i < Logger.getSinkCount(); i++) {
+            LogSinkStats sinkStats = Logger.getSinkStats(i);
+            JsonObject sink = sinks.add<JsonObject>();
+            sink["name"] = sinkStats.name;
+            sink["sent"] = sinkStats.sent;
+            sink["dropped"] = sinkStats.dropped;
+            sink["backlog"] = sinkStats.backlog;
         }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div class="header">
-            <h1>&#128640; Space Tornado Control</h1>
-        </div>
-        
-        <div id="firingIndicator" class="firing-indicator">&#128293; THRUSTERS FIRING!</div>
-        
-        <div class="status-card">
-            <h2>Current Outputs</h2>
-            <div class="status-item">
-                <span>Current Speed:</span>
-                <span class="value-display" id="currentSpeed">0%</span>
-            </div>
-            <div class="status-item">
-                <span>Target Speed:</span>
-                <span class="value-display" id="targetSpeed">0%</span>
-            </div>
-            <div class="status-item">
-                <span>Direction:</span>
-                <span class="value-display" id="direction">FORWARD</span>
-            </div>
-            <div class="status-item">
-                <span>Velocity:</span>
-                <span class="value-display" id="velocity">0.00</span>
-            </div>
-            <div class="status-item">
-                <span>System Enabled:</span>
-                <span class="value-display" id="enabled">NO</span>
-            </div>
-            <div class="status-item">
-                <span>Thrusters Firing:</span>
-                <span class="value-display" id="firing">NO</span>
-            </div>
-            <div class="status-item">
-                <span>Last Update:</span>
-                <span class="timestamp" id="timestamp">--</span>
-            </div>
-        </div>
-        
-        <div class="control-section">
-            <h2>Speed Control</h2>
-            <div class="slider-container">
-                <input type="range" min="0" max="100" value="0" class="slider" id="speedSlider">
-                <div style="text-align: center; margin-top: 10px;">
-                    <span class="value-display" id="speedValue">0%</span>
-                </div>
-            </div>
-        </div>
-        
-        <div class="control-section">
-            <h2>Direction</h2>
-            <button id="directionButton" style="width: 100%; padding: 15px; font-size: 20px; background: #2196F3; color: white; border: none; border-radius: 5px; cursor: pointer;">
-                FORWARD
-            </button>
-        </div>
-        
-        <div class="control-section">
-            <h2>Thrusters</h2>
-            <button class="fire-button" id="fireButton">
-                &#128293; FIRE THRUSTERS
-            </button>
-        </div>
-        
-        <div style="text-align: center; margin-top: 30px;">
-            <a href="/logs">View Logs</a>
-            <a href="/api/state">API State (JSON)</a>
-        </div>
-    </div>
-    
-    <script>
-        var currentDirection = true;
-        var isFiring = false;
-        
-        var speedSlider = document.getElementById("speedSlider");
-        var speedValue = document.getElementById("speedValue");
-        var fireButton = document.getElementById("fireButton");
-        var directionButton = document.getElementById("directionButton");
-        var firingIndicator = document.getElementById("firingIndicator");
-        
-        speedSlider.addEventListener("input", function() {
-            var value = this.value;
-            speedValue.textContent = value + "%";
-            setSpeed(value);
-        });
-        
-        function setSpeed(speed) {
-            fetch("/api/speed?value=" + speed, { method: "POST" });
+
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+
+    // API endpoint for text commands using the shared grammar (e.g. cmd=S50;D;F)
+    server.on("/api/command", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (!request->hasParam("cmd")) {
+            request->send(400, "text/plain", "Missing cmd parameter");
+            return;
         }
         
-        directionButton.addEventListener("click", function() {
-            var newDirection = !currentDirection;
-            fetch("/api/direction?value=" + (newDirection ? "forward" : "reverse"), { method: "POST" });
-        });
-        
-        fireButton.addEventListener("mousedown", startFire);
-        fireButton.addEventListener("mouseup", stopFire);
-        fireButton.addEventListener("mouseleave", stopFire);
-        fireButton.addEventListener("touchstart", function(e) { e.preventDefault(); startFire(); });
-        fireButton.addEventListener("touchend", function(e) { e.preventDefault(); stopFire(); });
+        const String& cmd = request->getParam("cmd")->value();
         
-        function startFire() {
-            if (!isFiring) {
-                isFiring = true;
-                fireButton.classList.add("firing");
-                fetch("/api/fire?state=1", { method: "POST" });
-            }
+        // Validate the whole batch first: a malformed request applies nothing
+        CommandParser validator(nullptr);
+        validator.feed(cmd.c_str(), cmd.length());
+        validator.flush();
+        if (validator.getErrorCount() > 0) {
+            request->send(400, "text/plain", "Invalid command - nothing applied");
+            return;
         }
         
-        function stopFire() {
-            if (isFiring) {
-                isFiring = false;
-                fireButton.classList.remove("firing");
-                fetch("/api/fire?state=0", { method: "POST" });
+        struct WebCommandResult { uint8_t posted; uint8_t rejected; } result = { 0, 0 };
+        CommandParser parser([](const ParsedCommand& cmd, void* context) {
+            WebCommandResult* result = static_cast<WebCommandResult*>(context);
+            if (cmd.op == '?') return;
+            if (postParsedCommand(cmd, SOURCE_WEB)) {
+                result->posted++;
+            } else {
+                result->rejected++;
             }
-        }
+        }, &result);
+        parser.feed(cmd.c_str(), cmd.length());
+        parser.flush();
         
-        function updateStatus() {
-            fetch("/api/state")
-                .then(function(response) { return response.json(); })
-                .then(function(data) {
-                    document.getElementById("currentSpeed").textContent = data.currentSpeed.toFixed(1) + "%";
-                    document.getElementById("targetSpeed").textContent = data.targetSpeed.toFixed(1) + "%";
-                    document.getElementById("direction").textContent = data.direction ? "FORWARD" : "REVERSE";
-                    document.getElementById("velocity").textContent = data.velocity.toFixed(2);
-                    document.getElementById("enabled").textContent = data.enabled ? "YES" : "NO";
-                    document.getElementById("firing").textContent = data.firingThrusters ? "YES" : "NO";
-                    document.getElementById("timestamp").textContent = new Date(data.timestamp).toLocaleTimeString();
-                    
-                    speedSlider.value = data.targetSpeed;
-                    speedValue.textContent = data.targetSpeed.toFixed(1) + "%";
-                    
-                    currentDirection = data.direction;
-                    directionButton.textContent = currentDirection ? "FORWARD" : "REVERSE";
-                    directionButton.style.background = currentDirection ? "#2196F3" : "#e91e63";
-                    
-                    firingIndicator.classList.toggle("active", data.firingThrusters);
-                    document.getElementById("firing").style.color = data.firingThrusters ? "#ff6f00" : "#4CAF50";
-                })
-                .catch(function(error) { console.error("Error:", error); });
+        if (result.rejected > 0) {
+            // Queue full part-way: say how much of the batch went through
+            char message[64];
+            snprintf(message, sizeof(message), "Command queue full - %u applied, %u rejected",
+                result.posted, result.rejected);
+            request->send(503, "text/plain", message);
+        } else {
+            request->send(200, "text/plain", "OK");
         }
-        
-        setInterval(updateStatus, 500);
-        updateStatus();
-    </script>
-</body>
-</html>
-)rawliteral";
-        request->send(200, "text/html", html);
     });
     
-    // API endpoint for state
-    server.on("/api/state", HTTP_GET, [](AsyncWebServerRequest *request) {
-        JsonDocument doc;
-        doc["currentSpeed"] = getCurrentSpeedPercent();
-        doc["targetSpeed"] = getTargetSpeedPercent();
-        doc["direction"] = getCurrentDirection();
-        doc["targetDirection"] = getTargetDirection();
-        doc["velocity"] = getApproximateVelocity();
-        doc["enabled"] = isEnabled();
-        doc["firingThrusters"] = isFiringThrusters();
-        doc["timestamp"] = millis();
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(200, "application/json", response);
+    // Batched setpoint (form body): id=<client>&seq=<n>&t=<client ms>[&s=<speed>][&d=0|1][&f=0|1]
+    // Out-of-order updates are discarded; bursts are coalesced to the newest per control tick.
+    server.on("/api/control", HTTP_POST, [](AsyncWebServerRequest *request) {
+        if (!request->hasParam("id", true) || !request->hasParam("seq", true) || !request->hasParam("t", true)) {
+            request->send(400, "text/plain", "Missing id, seq or t");
+            return;
+        }
+
+        Setpoint setpoint = {};
+        setpoint.clientId = strtoul(request->getParam("id", true)->value().c_str(), nullptr, 10);
+        setpoint.seq = strtoul(request->getParam("seq", true)->value().c_str(), nullptr, 10);
+        setpoint.clientTimeMs = strtoul(request->getParam("t", true)->value().c_str(), nullptr, 10);
+        if (request->hasParam("s", true)) {
+            setpoint.fields |= SETPOINT_SPEED;
+            setpoint.speed = request->getParam("s", true)->value().toFloat();
+        }
+        if (request->hasParam("d", true)) {
+            setpoint.fields |= SETPOINT_DIRECTION;
+            setpoint.forward = request->getParam("d", true)->value().toInt() != 0;
+        }
+        if (request->hasParam("f", true)) {
+            setpoint.fields |= SETPOINT_FIRE;
+            setpoint.fire = request->getParam("f", true)->value().toInt() != 0;
+        }
+
+        bool accepted = postSetpoint(setpoint, SOURCE_WEB) == SETPOINT_ACCEPTED;
+        char json[48];
+        snprintf(json, sizeof(json), "{\"accepted\":%s,\"seq\":%lu}", accepted ? "true" : "false", (unsigned long)setpoint.seq);
+        request->send(200, "application/json", json);
     });
     
     // API endpoint for speed
     server.on("/api/speed", HTTP_POST, [](AsyncWebServerRequest *request) {
         if (request->hasParam("value")) {
             float speed = request->getParam("value")->value().toFloat();
-            updateTargetSpeed(speed);
+            if (!postCommand(CMD_SET_SPEED, SOURCE_WEB, speed)) {
+                request->send(503, "text/plain", "Command queue full");
+                return;
+            }
             request->send(200, "text/plain", "Speed set to " + String(speed) + "%");
         } else {
             request->send(400, "text/plain", "Missing value parameter");
@@ -375,7 +631,10 @@ void initWebInterface() {
         if (request->hasParam("value")) {
             String value = request->getParam("value")->value();
             bool forward = (value == "forward");
-            updateTargetDirection(forward);
+            if (!postCommand(CMD_SET_DIRECTION, SOURCE_WEB, forward ? 1.0f : 0.0f)) {
+                request->send(503, "text/plain", "Command queue full");
+                return;
+            }
             request->send(200, "text/plain", "Direction set to " + value);
         } else {
             request->send(400, "text/plain", "Missing value parameter");
@@ -386,23 +645,63 @@ void initWebInterface() {
     server.on("/api/fire", HTTP_POST, [](AsyncWebServerRequest *request) {
         if (request->hasParam("state")) {
             bool firing = (request->getParam("state")->value().toInt() == 1);
-            setFiringThrusters(firing);
+            if (!postCommand(CMD_FIRE, SOURCE_WEB, firing ? 1.0f : 0.0f)) {
+                request->send(503, "text/plain", "Command queue full");
+                return;
+            }
             request->send(200, "text/plain", firing ? "Thrusters firing" : "Thrusters stopped");
         } else {
             request->send(400, "text/plain", "Missing state parameter");
         }
     });
     
-    // Logs page
+    // Logs page and JSON log API (streamed straight from the log ring)
     server.on("/logs", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", Logger.getLogsAsHtml());
+        sendLogStream(request, LOG_STREAM_HTML);
+    });
+    // ?since=<next from the previous response> returns only newer entries
+    server.on("/api/logs", HTTP_GET, [](AsyncWebServerRequest *request) {
+        uint32_t since = Logger.getFirstSeq();
+        if (request->hasParam("since")) {
+            since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+        }
+        sendLogStream(request, LOG_STREAM_JSON, since);
     });
     
     server.begin();
-    Logger.println("✅ Web interface initialized");
+    // One hub subscription for all WebSocket clients (the JSON shows 0.1 % resolution)
+    subscribeTelemetry("websocket", { WS_STATE_MIN_INTERVAL_MS, WS_STATE_HEARTBEAT_MS, 1, 1, TELEMETRY_FIELD_ALL },
+        onWebSocketTelemetry);
+    webInterfaceStarted = true;
+    LOG_INFO("✅ Web interface initialized");
 }
 
+// Network task: keep the cached state JSON current and push it to WebSocket clients
+// when the telemetry hub says so (rate, heartbeat and filters live in the hub).
+// HTTP requests are handled by AsyncWebServer on its own task.
 void handleWebInterface() {
-    // AsyncWebServer handles requests automatically, no need to call anything here
-    // This function exists for consistency with the interface
+    if (!webInterfaceStarted) return;
+
+    static unsigned long lastCleanup = 0;
+    if (millis() - lastCleanup > 1000) {
+        ws.cleanupClients(WS_MAX_CLIENTS);
+        lastCleanup = millis();
+    }
+
+    // The cache follows the state at most every WS_STATE_MIN_INTERVAL_MS, or at once for a push
+    static unsigned long lastRefresh = 0;
+    bool push = wsPushPending.exchange(false, std::memory_order_acquire);
+    if (push || millis() - lastRefresh >= WS_STATE_MIN_INTERVAL_MS) {
+        refreshStateJson();
+        lastRefresh = millis();
+    }
+    // No clients: nothing to do (new clients get the state on connect)
+    if (!push || ws.count() == 0) return;
+
+    // A client with a full send queue gets the newest state once it drains
+    if (!ws.availableForWriteAll()) {
+        wsPushPending.store(true, std::memory_order_relaxed);
+        return;
+    }
+    ws.textAll(renderBuffer.text, renderBuffer.length);
 }
@@ -1,236 +1,435 @@
 #include "wifi_manager.h"
+#include "config.h"
 #include "logging.h"
 #include "web_interface.h"
-#include <nvs_flash.h>
+#include "udp_control.h"
 #include <ESPmDNS.h>
+#include <atomic>
 
 // WiFi Setup Variables
 DNSServer dnsServer;
 Preferences wifiPrefs;
-bool isConfigMode = false;
-unsigned long portalStartTime = 0;
 
 // WiFi connection callback
 static WiFiConnectedCallback wifiConnectedCallback = nullptr;
 
-void saveWiFiCredentials(const String& ssid, const String& password) {
-    esp_err_t err = nvs_flash_init();
-    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        Logger.println("⚠️ NVS partition issue, erasing and reinitializing...");
-        nvs_flash_erase();
-        nvs_flash_init();
-    }
-    
-    if (!wifiPrefs.begin("wifi", false)) {
-        Logger.println("❌ Failed to open WiFi preferences for writing");
-        return;
-    }
-    
-    wifiPrefs.putString("ssid", ssid);
-    wifiPrefs.putString("password", password);
-    wifiPrefs.end();
-    
-    Logger.printf("✅ WiFi credentials saved for SSID: %s\n", ssid.c_str());
+// Set by the WiFi event task, consumed by handleWiFiLoop()
+enum WiFiEventFlags : uint32_t {
+    EVENT_GOT_IP = 1 << 0,
+    EVENT_DISCONNECTED = 1 << 1,
+};
+
+static std::atomic<uint32_t> pendingEvents(0);
+static std::atomic<uint8_t> disconnectReason(0);
+static std::atomic<bool> credentialsChanged(false);
+static std::atomic<uint32_t> gotIpAtMs(0);
+
+// Last successful association and lease, kept in NVS so the next boot (or
+// reconnect) can skip the channel scan, and DHCP with WIFI_FAST_CONNECT_STATIC_IP.
+// No padding: compared with memcmp.
+struct WiFiConnectionCache {
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns1;
+    uint32_t dns2;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+};
+
+static WiFiConnectionCache cache;
+static bool hasCache = false;
+static bool useCache = false;               // Next attempt is directed
+static bool fastAttempt = false;            // Current attempt is directed
+static bool staticIp = false;               // Cached lease applied with WiFi.config()
+
+// State machine (network task only)
+static WiFiState state = WIFI_STATE_OFF;
+static char ssid[33];
+static char password[65];
+static uint32_t attemptStartMs = 0;
+static uint32_t nextAttemptMs = 0;
+static uint32_t offlineSinceMs = 0;        // Start of the current outage (fallback AP timer)
+static uint32_t connectedAtMs = 0;
+static uint32_t backoffMs = 0;
+static bool apActive = false;
+static uint32_t apRetryAtMs = 0;
+static bool servicesStarted = false;        // mDNS, UDP control
+static bool otaStarted = false;
+
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+static WiFiStats stats = {};
+
+static const char* STATE_NAMES[] = { "off", "portal", "connecting", "connected", "backoff" };
+
+static void setState(WiFiState newState) {
+    state = newState;
+    portENTER_CRITICAL(&statsMux);
+    stats.state = newState;
+    stats.apActive = apActive;
+    stats.backoffMs = backoffMs;
+    portEXIT_CRITICAL(&statsMux);
 }
 
-bool connectToWiFi() {
-    esp_err_t err = nvs_flash_init();
-    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        Logger.println("⚠️ NVS partition issue, erasing and reinitializing...");
-        nvs_flash_erase();
-        err = nvs_flash_init();
-    }
-    if (err != ESP_OK) {
-        Logger.printf("❌ NVS init failed: %d\n", err);
+// Runs on the Arduino event task: record and return
+static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            gotIpAtMs.store(millis());
+            pendingEvents.fetch_or(EVENT_GOT_IP);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            disconnectReason.store(info.wifi_sta_disconnected.reason);
+            pendingEvents.fetch_or(EVENT_DISCONNECTED);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            pendingEvents.fetch_or(EVENT_DISCONNECTED);
+            break;
+        default:
+            break;
     }
-    
+}
+
+// Loads saved credentials into ssid/password and the connection cache; false if
+// there are no credentials. NVS itself is initialized by the Arduino core.
+static bool loadWiFiCredentials() {
+    ssid[0] = '\0';
+    password[0] = '\0';
+    hasCache = false;
+
     if (!wifiPrefs.begin("wifi", true)) {
-        Logger.println("ℹ️ No WiFi preferences found (first boot?)");
+        LOG_INFO("ℹ️ No WiFi preferences found (first boot?)");
         return false;
     }
-    
-    String ssid = wifiPrefs.getString("ssid", "");
-    String password = wifiPrefs.getString("password", "");
+
+    wifiPrefs.getString("ssid", ssid, sizeof(ssid));
+    wifiPrefs.getString("password", password, sizeof(password));
+    hasCache = wifiPrefs.getBytes("cache", &cache, sizeof(cache)) == sizeof(cache) && cache.channel != 0;
     wifiPrefs.end();
-    
-    if (ssid.length() == 0) {
-        Logger.println("📡 No saved WiFi credentials found");
+    useCache = hasCache;
+
+    if (ssid[0] == '\0') {
+        LOG_INFO("📡 No saved WiFi credentials found");
         return false;
     }
-    
-    Logger.printf("📡 Starting WiFi connection to: %s\n", ssid.c_str());
-    
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
-    
-    Logger.println("📡 WiFi connection initiated in background");
     return true;
 }
 
-bool startConfigPortalSafe() {
-    Logger.println("🔧 Starting WiFi configuration portal (safe mode)...");
-    
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_OFF);
-    delay(2000);
-    
-    Logger.println("🔧 Setting WiFi mode to AP...");
-    for (int retry = 0; retry < 3; retry++) {
-        if (WiFi.mode(WIFI_AP)) {
-            Logger.println("✅ WiFi mode set to AP");
-            break;
-        }
-        Logger.printf("⚠️ WiFi mode retry %d/3\n", retry + 1);
-        delay(1000);
-        if (retry == 2) {
-            Logger.println("❌ Failed to set WiFi mode after retries");
-            return false;
-        }
+void saveWiFiCredentials(const String& newSsid, const String& newPassword) {
+    Preferences prefs;     // Own handle: may run on the web server task
+    if (!prefs.begin("wifi", false)) {
+        LOG_ERROR("❌ Failed to open WiFi preferences for writing");
+        return;
     }
-    
-    delay(1000);
-    
-    Logger.println("🔧 Starting SoftAP...");
-    for (int retry = 0; retry < 3; retry++) {
-        if (WiFi.softAP(WIFI_AP_NAME, WIFI_AP_PASSWORD)) {
-            Logger.println("✅ SoftAP started successfully");
-            isConfigMode = true;
-            break;
-        }
-        Logger.printf("⚠️ SoftAP retry %d/3\n", retry + 1);
-        delay(1000);
-        if (retry == 2) {
-            Logger.println("❌ Failed to start SoftAP after retries");
-            return false;
-        }
+
+    prefs.putString("ssid", newSsid);
+    prefs.putString("password", newPassword);
+    prefs.remove("cache");      // Belongs to the old network
+    prefs.end();
+
+    LOG_INFO("✅ WiFi credentials saved for SSID: %s", newSsid.c_str());
+    credentialsChanged.store(true);
+}
+
+static void startOTA() {
+    if (otaStarted) return;
+    ArduinoOTA.begin();
+    otaStarted = true;
+    LOG_INFO("✅ OTA Ready on port %d", OTA_PORT);
+}
+
+// Setup access point next to the station (or alone without credentials).
+// A failure is retried on a later step instead of blocking here.
+static void startAccessPoint(uint32_t now) {
+    if (apActive || (int32_t)(now - apRetryAtMs) < 0) return;
+
+    WiFi.mode(ssid[0] ? WIFI_AP_STA : WIFI_AP);
+    if (!WiFi.softAP(WIFI_AP_NAME, WIFI_AP_PASSWORD)) {
+        LOG_WARN("⚠️ SoftAP failed to start - retrying in %d ms", WIFI_AP_RETRY_MS);
+        apRetryAtMs = now + WIFI_AP_RETRY_MS;
+        return;
     }
-    
-    delay(1000);
-    
+    apActive = true;
+
     IPAddress apIP = WiFi.softAPIP();
-    Logger.printf("📡 WiFi configuration portal started\n");
-    Logger.printf("AP Name: %s\n", WIFI_AP_NAME);
-    Logger.printf("AP Password: %s\n", WIFI_AP_PASSWORD);
-    Logger.printf("AP IP: %s\n", apIP.toString().c_str());
-    
     dnsServer.start(53, "*", apIP);
-    
-    initConfigPortalWebInterface();
-    
-    return true;
+    LOG_INFO("📡 WiFi setup access point '%s' up at %s (password %s)", WIFI_AP_NAME,
+        apIP.toString().c_str(), WIFI_AP_PASSWORD);
+
+    initWebInterface();
+    startOTA();
+}
+
+static void stopAccessPoint() {
+    if (!apActive) return;
+    dnsServer.stop();
+    WiFi.softAPdisconnect(true);    // Back to station-only mode
+    apActive = false;
+    LOG_INFO("📡 WiFi setup access point closed");
+}
+
+// Saves the current association (and lease, if it is reused) when it differs from the cache
+static void saveConnectionCache() {
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid == nullptr) return;
+
+    WiFiConnectionCache current = {};
+#if WIFI_FAST_CONNECT_STATIC_IP
+    current.ip = WiFi.localIP();
+    current.gateway = WiFi.gatewayIP();
+    current.subnet = WiFi.subnetMask();
+    current.dns1 = WiFi.dnsIP(0);
+    current.dns2 = WiFi.dnsIP(1);
+#endif
+    memcpy(current.bssid, bssid, sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    if (hasCache && memcmp(&current, &cache, sizeof(cache)) == 0) return;
+
+    Preferences prefs;
+    if (!prefs.begin("wifi", false)) return;
+    prefs.putBytes("cache", &current, sizeof(current));
+    prefs.end();
+    cache = current;
+    hasCache = true;
+    LOG_DEBUG("📡 Cached WiFi connection (channel %u)", cache.channel);
+}
+
+// Directed attempt (cached BSSID and channel, plus the lease with
+// WIFI_FAST_CONNECT_STATIC_IP) when the cache is usable, otherwise a full scan with DHCP
+static void startAttempt(uint32_t now) {
+    if (!apActive) {
+        WiFi.mode(WIFI_STA);
+    }
+    fastAttempt = useCache && hasCache;
+    if (fastAttempt) {
+#if WIFI_FAST_CONNECT_STATIC_IP
+        WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet),
+            IPAddress(cache.dns1), IPAddress(cache.dns2));
+        staticIp = true;
+#endif
+        WiFi.begin(ssid, password, cache.channel, cache.bssid);
+    } else {
+        if (staticIp) {
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);     // Back to DHCP
+            staticIp = false;
+        }
+        WiFi.begin(ssid, password);
+    }
+    attemptStartMs = now;
+    portENTER_CRITICAL(&statsMux);
+    stats.attempts++;
+    portEXIT_CRITICAL(&statsMux);
+    LOG_INFO("📡 Connecting to %s%s...", ssid, fastAttempt ? " (cached channel and address)" : "");
+    setState(WIFI_STATE_CONNECTING);
+}
+
+// Exponential backoff between attempts, reset by a successful connection
+static void scheduleRetry(uint32_t now) {
+    backoffMs = (backoffMs == 0) ? WIFI_BACKOFF_MIN_MS : min<uint32_t>(backoffMs * 2, WIFI_BACKOFF_MAX_MS);
+    nextAttemptMs = now + backoffMs;
+    LOG_DEBUG("📡 Next WiFi attempt in %lu ms", (unsigned long)backoffMs);
+    setState(WIFI_STATE_BACKOFF);
+}
+
+// A failed directed attempt falls back to a full scan at once; others back off
+static void attemptFailed(uint32_t now) {
+    if (!fastAttempt) {
+        scheduleRetry(now);
+        return;
+    }
+    LOG_WARN("⚠️ Cached WiFi connection failed - falling back to a full scan");
+    useCache = false;
+    portENTER_CRITICAL(&statsMux);
+    stats.fastConnectFailures++;
+    portEXIT_CRITICAL(&statsMux);
+    startAttempt(now);
+}
+
+static void onConnected(uint32_t now) {
+    connectedAtMs = now;
+    backoffMs = 0;
+    portENTER_CRITICAL(&statsMux);
+    stats.connects++;
+    stats.fastConnect = fastAttempt;
+    portEXIT_CRITICAL(&statsMux);
+    setState(WIFI_STATE_CONNECTED);
+
+    LOG_INFO("✅ WiFi connected successfully!");
+    LOG_INFO("IP Address: %s", WiFi.localIP().toString().c_str());
+    LOG_INFO("Signal Strength: %d dBm", WiFi.RSSI());
+
+    saveConnectionCache();
+    useCache = true;
+
+    if (servicesStarted) return;
+    servicesStarted = true;
+
+    // Web control first; it is what the boot timing measures
+    initWebInterface();
+    uint32_t webReadyMs = millis();
+    portENTER_CRITICAL(&statsMux);
+    stats.bootConnectedMs = gotIpAtMs.load();
+    stats.bootWebReadyMs = webReadyMs;
+    portEXIT_CRITICAL(&statsMux);
+    LOG_INFO("⏱️ Web control ready %lu ms after boot (IP at %lu ms, %s)", (unsigned long)webReadyMs,
+        (unsigned long)gotIpAtMs.load(), fastAttempt ? "cached connection" : "full scan");
+
+    // Start mDNS so device is discoverable at spacetornado.local
+    if (MDNS.begin("spacetornado")) {
+        MDNS.addService("http", "tcp", 80);
+        LOG_INFO("📡 mDNS started: spacetornado.local");
+    } else {
+        LOG_WARN("⚠️ mDNS failed to start");
+    }
+
+    startOTA();
+    initUdpControl();
+
+    if (wifiConnectedCallback != nullptr) {
+        LOG_DEBUG("📞 Calling WiFi connected callback...");
+        wifiConnectedCallback();
+    }
+}
+
+static void onDisconnected(uint32_t now) {
+    uint8_t reason = disconnectReason.load();
+    // Our own WiFi.disconnect() ahead of a new attempt
+    if (reason == WIFI_REASON_ASSOC_LEAVE && state == WIFI_STATE_CONNECTING) return;
+    portENTER_CRITICAL(&statsMux);
+    stats.lastDisconnectReason = reason;
+    if (state == WIFI_STATE_CONNECTED) stats.disconnects++;
+    portEXIT_CRITICAL(&statsMux);
+
+    if (state == WIFI_STATE_CONNECTED) {
+        LOG_WARN("⚠️ WiFi connection lost (reason %u)", reason);
+        offlineSinceMs = now;
+        backoffMs = 0;
+        scheduleRetry(now);
+    } else if (state == WIFI_STATE_CONNECTING) {
+        LOG_DEBUG("📡 WiFi attempt failed (reason %u)", reason);
+        attemptFailed(now);
+    }
 }
 
 void initWiFi(WiFiConnectedCallback onConnected) {
-    Logger.printf("🔧 Starting WiFi initialization (non-blocking)...\n");
-    
+    LOG_INFO("🔧 Starting WiFi initialization (non-blocking)...");
+
     wifiConnectedCallback = onConnected;
-    
-    Logger.println("🔧 Checking for saved credentials...");
-    bool hasCredentials = connectToWiFi();
-    
-    if (!hasCredentials) {
-        Logger.println("📱 No saved WiFi credentials - starting configuration portal...");
-        if (startConfigPortalSafe()) {
-            portalStartTime = millis();
-        }
+
+    // The state machine owns reconnects; credentials live in our own namespace
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(onWiFiEvent);
+
+    uint32_t now = millis();
+    offlineSinceMs = now;
+    if (loadWiFiCredentials()) {
+        startAttempt(now);
     } else {
-        isConfigMode = false;
+        LOG_INFO("📱 No saved WiFi credentials - starting configuration portal...");
+        setState(WIFI_STATE_PORTAL);
+        startAccessPoint(now);
     }
-    
-    Logger.println("📡 WiFi initialization complete - connection status will be monitored in background");
+
+    LOG_INFO("📡 WiFi initialization complete - connection status will be monitored in background");
 }
 
 void initOTA() {
     ArduinoOTA.setHostname(OTA_HOSTNAME);
     ArduinoOTA.setPassword(OTA_PASSWORD);
     ArduinoOTA.setPort(OTA_PORT);
-    
-    ArduinoOTA.onStart([]() { Logger.println("OTA Start"); });
-    ArduinoOTA.onEnd([]() { Logger.println("OTA End"); });
-    ArduinoOTA.onError([](ota_error_t error) { Logger.printf("OTA Error: %u\n", error); });
-    
-    Logger.println("🔄 OTA configuration complete - will start when WiFi is ready");
-}
 
-void startOTA() {
-    ArduinoOTA.begin();
-    Logger.printf("✅ OTA Ready: %s:%d\n", WiFi.localIP().toString().c_str(), OTA_PORT);
-}
+    ArduinoOTA.onStart([]() { LOG_INFO("OTA Start"); });
+    ArduinoOTA.onEnd([]() { LOG_INFO("OTA End"); });
+    ArduinoOTA.onError([](ota_error_t error) { LOG_ERROR("OTA Error: %u", error); });
 
-void stopOTA() {
-    ArduinoOTA.end();
-    Logger.println("🔄 OTA stopped due to WiFi change");
+    LOG_INFO("🔄 OTA configuration complete - will start when WiFi is ready");
 }
 
 void handleWiFiLoop() {
-    static bool connectionLogged = false;
-    static bool otaStarted = false;
-    static unsigned long connectionStartTime = 0;
-    
-    if (isConfigMode) {
-        dnsServer.processNextRequest();
-        // Web interface is handled asynchronously by AsyncWebServer
-        
-        if (!otaStarted) {
-            startOTA();
-            otaStarted = true;
-        }
-    } else if (WiFi.getMode() == WIFI_STA) {
-        if (WiFi.status() == WL_CONNECTED && !connectionLogged) {
-            Logger.printf("✅ WiFi connected successfully!\n");
-            Logger.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-            Logger.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
-            
-            IPAddress dns1(8, 8, 8, 8);
-            IPAddress dns2(1, 1, 1, 1);
-            WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), dns1, dns2);
-            Logger.println("🌐 DNS configured: 8.8.8.8, 1.1.1.1");
-            
-            if (wifiConnectedCallback != nullptr) {
-                Logger.println("📞 Calling WiFi connected callback...");
-                wifiConnectedCallback();
-            }
-            
-            // Start mDNS so device is discoverable at spacetornado.local
-            if (MDNS.begin("spacetornado")) {
-                MDNS.addService("http", "tcp", 80);
-                Logger.println("📡 mDNS started: spacetornado.local");
-            } else {
-                Logger.println("⚠️ mDNS failed to start");
+    if (state == WIFI_STATE_OFF) return;
+    uint32_t startUs = micros();
+    uint32_t now = millis();
+
+    // New credentials from the setup page: connect at once, keep the AP for the user
+    if (credentialsChanged.exchange(false)) {
+        if (loadWiFiCredentials()) {
+            if (state == WIFI_STATE_CONNECTED || state == WIFI_STATE_CONNECTING) {
+                WiFi.disconnect();
             }
-            
-            if (!otaStarted) {
-                startOTA();
-                otaStarted = true;
+            if (apActive) WiFi.mode(WIFI_AP_STA);
+            backoffMs = 0;
+            offlineSinceMs = now;
+            startAttempt(now);
+        }
+    }
+
+    uint32_t events = pendingEvents.exchange(0);
+    if (events & EVENT_GOT_IP) {
+        onConnected(now);
+    }
+    // Both in one step: only a disconnect after the IP counts
+    if ((events & EVENT_DISCONNECTED) && !(state == WIFI_STATE_CONNECTED && WiFi.isConnected())) {
+        onDisconnected(now);
+    }
+
+    switch (state) {
+        case WIFI_STATE_CONNECTING:
+            if (now - attemptStartMs >= (fastAttempt ? WIFI_FAST_CONNECT_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS)) {
+                LOG_WARN("⚠️ WiFi attempt timed out");
+                WiFi.disconnect();
+                attemptFailed(now);
             }
-            connectionLogged = true;
-            // Initialize main web interface when connected
-            extern void initWebInterface();
-            initWebInterface();
-        } else if (WiFi.status() != WL_CONNECTED && connectionStartTime == 0) {
-            connectionStartTime = millis();
-        } else if (WiFi.status() != WL_CONNECTED && connectionStartTime > 0 && 
-                 (millis() - connectionStartTime) > 30000) {
-            Logger.println("❌ WiFi connection timeout - starting configuration portal");
-            
-            if (otaStarted) {
-                stopOTA();
-                otaStarted = false;
+            break;
+        case WIFI_STATE_BACKOFF:
+            if ((int32_t)(now - nextAttemptMs) >= 0) {
+                startAttempt(now);
             }
-            
-            connectionStartTime = 0;
-            connectionLogged = false;
-            
-            if (startConfigPortalSafe()) {
-                portalStartTime = millis();
+            break;
+        case WIFI_STATE_PORTAL:
+            startAccessPoint(now);      // Retries a failed start
+            break;
+        case WIFI_STATE_CONNECTED:
+            // Close the fallback AP once nobody is using it
+            if (apActive && now - connectedAtMs >= WIFI_AP_LINGER_MS && WiFi.softAPgetStationNum() == 0) {
+                stopAccessPoint();
             }
-        }
+            break;
+        default:
+            break;
     }
-    
-    if (otaStarted && (WiFi.status() == WL_CONNECTED || isConfigMode)) {
+
+    // Offline for too long: bring up the setup AP next to the station
+    if ((state == WIFI_STATE_CONNECTING || state == WIFI_STATE_BACKOFF) &&
+        now - offlineSinceMs >= WIFI_AP_FALLBACK_MS) {
+        if (!apActive) LOG_WARN("⚠️ No WiFi connection for %d s - starting setup access point", WIFI_AP_FALLBACK_MS / 1000);
+        startAccessPoint(now);
+    }
+
+    if (apActive) {
+        dnsServer.processNextRequest();
+    }
+    if (otaStarted && (apActive || state == WIFI_STATE_CONNECTED)) {
         ArduinoOTA.handle();
     }
-    
-    // Web interface is handled asynchronously by AsyncWebServer
+
+    uint32_t stepUs = micros() - startUs;
+    portENTER_CRITICAL(&statsMux);
+    stats.apActive = apActive;
+    stats.lastStepUs = stepUs;
+    if (stepUs > stats.maxStepUs) stats.maxStepUs = stepUs;
+    portEXIT_CRITICAL(&statsMux);
 }
 
+WiFiStats getWiFiStats() {
+    portENTER_CRITICAL(&statsMux);
+    WiFiStats copy = stats;
+    portEXIT_CRITICAL(&statsMux);
+    copy.apStations = copy.apActive ? WiFi.softAPgetStationNum() : 0;
+    return copy;
+}
+
+const char* getWiFiStateName(WiFiState state) {
+    return (state <= WIFI_STATE_BACKOFF) ? STATE_NAMES[state] : "?";
+}
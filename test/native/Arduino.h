@@ -0,0 +1,99 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Minimal Arduino/FreeRTOS surface for building firmware modules on the host
+// (pio test -e native). Critical sections lock a mutex per mux; tasks
+// are never started; pins and PWM channels are no-ops. Tests can advance the
+// clock with nativeAdvanceClock() to run control loops faster than real time.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include "Print.h"
+#include "WString.h"
+
+using std::min;
+using std::max;
+using std::abs;
+
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+
+inline uint64_t& nativeClockOffsetUs() {
+    static uint64_t offset = 0;
+    return offset;
+}
+
+inline void nativeAdvanceClock(uint32_t ms) {
+    nativeClockOffsetUs() += (uint64_t)ms * 1000;
+}
+
+inline uint32_t micros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint32_t)(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() + nativeClockOffsetUs());
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+inline void delay(uint32_t) {}
+
+#define LOW 0
+#define HIGH 1
+#define OUTPUT 0x03
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline double ledcSetup(uint8_t, double frequency, uint8_t) { return frequency; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t, uint32_t) {}
+
+// Each mux is its own lock, as on the ESP32: sections on different muxes run
+// concurrently, and the host suites check the exclusion each mux provides.
+// Recursive, like a spinlock re-taken by the core that holds it.
+struct portMUX_TYPE {
+    portMUX_TYPE(int) {}
+    std::recursive_mutex mutex;
+};
+#define portMUX_INITIALIZER_UNLOCKED 0
+
+#define portENTER_CRITICAL(mux) (mux)->mutex.lock()
+#define portEXIT_CRITICAL(mux) (mux)->mutex.unlock()
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+
+typedef void* TaskHandle_t;
+#define pdTRUE 1
+#define pdMS_TO_TICKS(ms) (ms)
+
+// Distinct per thread, like a FreeRTOS task handle
+inline void* xTaskGetCurrentTaskHandle() {
+    static thread_local char handle;
+    return &handle;
+}
+
+inline int xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, int, TaskHandle_t* handle, int) {
+    if (handle) *handle = nullptr;
+    return pdTRUE;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(int, uint32_t) { return 0; }
+
+struct NativeEsp {
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+    uint32_t getMaxAllocHeap() { return 0; }
+    void restart() {}
+};
+
+inline NativeEsp ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,83 @@
+#ifndef NATIVE_ASYNC_UDP_H
+#define NATIVE_ASYNC_UDP_H
+
+// In-memory AsyncUDP for host tests: the test delivers datagrams with
+// nativeAsyncUdp()->receive() and collects what the firmware sent from
+// sent. Nothing touches a real socket.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <vector>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+    bool operator==(const IPAddress& other) const { return address == other.address; }
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", address & 0xFF, (address >> 8) & 0xFF,
+            (address >> 16) & 0xFF, address >> 24);
+        return String(text);
+    }
+
+private:
+    uint32_t address = 0;
+};
+
+class AsyncUDPPacket {
+public:
+    AsyncUDPPacket(const uint8_t* data, size_t length, const IPAddress& ip, uint16_t port)
+        : bytes(data), size(length), ip(ip), port(port) {}
+    const uint8_t* data() { return bytes; }
+    size_t length() { return size; }
+    IPAddress remoteIP() { return ip; }
+    uint16_t remotePort() { return port; }
+
+private:
+    const uint8_t* bytes;
+    size_t size;
+    IPAddress ip;
+    uint16_t port;
+};
+
+struct NativeDatagram {
+    std::vector<uint8_t> data;
+    IPAddress ip;
+    uint16_t port;
+};
+
+class AsyncUDP;
+
+// The socket that last called listen()
+inline AsyncUDP*& nativeAsyncUdp() {
+    static AsyncUDP* instance = nullptr;
+    return instance;
+}
+
+class AsyncUDP {
+public:
+    bool listen(uint16_t) {
+        nativeAsyncUdp() = this;
+        return true;
+    }
+    void onPacket(std::function<void(AsyncUDPPacket&)> callback) { handler = callback; }
+    size_t writeTo(const uint8_t* data, size_t length, const IPAddress& ip, uint16_t port) {
+        sent.push_back({ std::vector<uint8_t>(data, data + length), ip, port });
+        return length;
+    }
+
+    void receive(const void* data, size_t length, const IPAddress& ip, uint16_t port) {
+        AsyncUDPPacket packet((const uint8_t*)data, length, ip, port);
+        if (handler) handler(packet);
+    }
+
+    std::vector<NativeDatagram> sent;
+
+private:
+    std::function<void(AsyncUDPPacket&)> handler;
+};
+
+#endif // NATIVE_ASYNC_UDP_H
@@ -0,0 +1,23 @@
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (size-- && write(*buffer++)) written++;
+        return written;
+    }
+    virtual int availableForWrite() { return 0; }
+
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t println(const char* text = "") { return print(text) + print("\r\n"); }
+};
+
+#endif // NATIVE_PRINT_H
@@ -0,0 +1,18 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <string>
+
+// Just enough of Arduino's String for headers that mention it
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text) {}
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.length(); }
+
+private:
+    std::string value;
+};
+
+#endif // NATIVE_WSTRING_H
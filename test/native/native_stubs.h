@@ -0,0 +1,24 @@
+#ifndef NATIVE_STUBS_H
+#define NATIVE_STUBS_H
+
+// Host stand-ins for the ESP-only modules that the sources under test call
+// into. Include from exactly one file of each test suite.
+
+#include "crash_log.h"
+#include "radio_profile.h"
+
+static PreviousSession nativePreviousSession = {};
+
+const PreviousSession& getPreviousSession() {
+    return nativePreviousSession;
+}
+
+bool getPreviousSessionRecord(int index, LogRecord& out) {
+    return false;
+}
+
+bool setRadioProfile(int index) {
+    return false;
+}
+
+#endif // NATIVE_STUBS_H
@@ -0,0 +1,161 @@
+// Command bus setpoint ordering: clients are tracked per transport, so a burst
+// of clients on one transport can't evict another's and let its stale
+// updates through.
+// Run with: pio test -e native -f test_command_bus
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "command_bus.h"
+#include "rocket_state.h"
+#include "native_stubs.h"
+
+void setUp(void) {
+    initRocketState();
+    initCommandBus();
+}
+
+void tearDown(void) {}
+
+static SetpointResult post(uint32_t clientId, uint32_t seq, CommandSource source) {
+    nativeAdvanceClock(1);
+    return postSetpoint({ clientId, seq, seq, SETPOINT_SPEED, (float)(seq % 100), true, false }, source);
+}
+
+void test_out_of_order_update_is_stale(void) {
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(7, 10, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_STALE, post(7, 10, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_STALE, post(7, 9, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(7, 11, SOURCE_UDP));
+}
+
+// More web clients than the web pool holds: they recycle each other's slots
+// but leave the UDP and BLE clients' slots alone.
+void test_transports_do_not_evict_each_other(void) {
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(1, 100, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(BLE_SETPOINT_CLIENT_ID, 50, SOURCE_BLE));
+    for (uint32_t id = 1; id <= SETPOINT_CLIENT_SLOTS_WEB + 2; id++) {
+        TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(id, 1000 + id, SOURCE_WEB));
+    }
+
+    TEST_ASSERT_EQUAL(SETPOINT_STALE, post(1, 99, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_STALE, post(BLE_SETPOINT_CLIENT_ID, 49, SOURCE_BLE));
+
+    // The web clients pushed out of their own pool start over
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(1, 1, SOURCE_WEB));
+}
+
+void test_same_id_on_two_transports_is_two_clients(void) {
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(3, 20, SOURCE_UDP));
+    TEST_ASSERT_EQUAL(SETPOINT_ACCEPTED, post(3, 5, SOURCE_WEB));
+    TEST_ASSERT_EQUAL(SETPOINT_STALE, post(3, 19, SOURCE_UDP));
+    processCommands();
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.0f, getTargetSpeedPercent());
+}
+
+// A connection's ack comes from its own record, even after its client slot
+// was recycled before the control task got to the setpoint
+void test_ack_record_survives_client_eviction(void) {
+    SetpointAck ack;
+    uint32_t seq = 0;
+    resetSetpointAck(ack, BLE_SETPOINT_CLIENT_ID);
+    TEST_ASSERT_FALSE(getSetpointAck(ack, seq));
+
+    nativeAdvanceClock(1);
+    postSetpoint({ BLE_SETPOINT_CLIENT_ID, 42, 42, SETPOINT_SPEED, 10.0f, true, false }, SOURCE_BLE, &ack);
+    for (uint32_t id = 1; id <= SETPOINT_CLIENT_SLOTS_BLE; id++) {
+        post(BLE_SETPOINT_CLIENT_ID + id, 1, SOURCE_BLE);
+    }
+    processCommands();
+
+    TEST_ASSERT_TRUE(getSetpointAck(ack, seq));
+    TEST_ASSERT_EQUAL_UINT32(42, seq);
+}
+
+// A record rebound to a new connection before the apply isn't given the old seq
+void test_rebound_ack_record_ignores_old_client(void) {
+    SetpointAck ack;
+    uint32_t seq = 0;
+    resetSetpointAck(ack, BLE_SETPOINT_CLIENT_ID);
+    postSetpoint({ BLE_SETPOINT_CLIENT_ID, 7, 7, SETPOINT_SPEED, 10.0f, true, false }, SOURCE_BLE, &ack);
+    resetSetpointAck(ack, BLE_SETPOINT_CLIENT_ID + 1);
+    processCommands();
+    TEST_ASSERT_FALSE(getSetpointAck(ack, seq));
+}
+
+// One thread per BLE connection posts a run of setpoints while the "control
+// task" drains the mailbox: nothing lost, nothing stale, every ack lands.
+void test_concurrent_clients_and_control_task(void) {
+    const int clients = SETPOINT_CLIENT_SLOTS_BLE;
+    const uint32_t updates = 50000;
+    SetpointAck acks[SETPOINT_CLIENT_SLOTS_BLE];
+    std::atomic<uint32_t> notAccepted(0);
+    std::atomic<int> running(clients);
+    CommandBusStats before = getCommandBusStats();
+
+    std::vector<std::thread> posters;
+    for (int c = 0; c < clients; c++) {
+        resetSetpointAck(acks[c], BLE_SETPOINT_CLIENT_ID + c);
+        posters.emplace_back([&, c]() {
+            for (uint32_t seq = 1; seq <= updates; seq++) {
+                Setpoint setpoint = { BLE_SETPOINT_CLIENT_ID + (uint32_t)c, seq, seq, SETPOINT_SPEED,
+                                      (float)(seq % 100), true, false };
+                if (postSetpoint(setpoint, SOURCE_BLE, &acks[c]) != SETPOINT_ACCEPTED) notAccepted++;
+                if (seq % 16 == 0) std::this_thread::yield();   // Interleave on a single core too
+            }
+            running--;
+        });
+    }
+    while (running.load() > 0) {
+        processCommands();
+        std::this_thread::yield();
+    }
+    for (std::thread& poster : posters) poster.join();
+    processCommands();
+
+    CommandBusStats after = getCommandBusStats();
+    TEST_ASSERT_EQUAL_UINT32(0, notAccepted.load());
+    TEST_ASSERT_EQUAL_UINT32(clients * updates, after.setpointsAccepted - before.setpointsAccepted);
+    for (int c = 0; c < clients; c++) {
+        uint32_t seq = 0;
+        TEST_ASSERT_TRUE(getSetpointAck(acks[c], seq));
+        TEST_ASSERT_EQUAL_UINT32(updates, seq);
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "%u setpoints from %d threads, %u applied",
+        clients * updates, clients, after.setpointsApplied - before.setpointsApplied);
+    TEST_MESSAGE(message);
+}
+
+void test_reset_zeroes_every_counter(void) {
+    postCommand(CMD_SET_SPEED, SOURCE_SERIAL, 10.0f);
+    post(1, 5, SOURCE_WEB);
+    post(1, 5, SOURCE_WEB);
+    processCommands();
+    TEST_ASSERT_TRUE(getCommandBusStats().applied > 0);
+
+    resetCommandBusStats();
+    processCommands();
+    CommandBusStats stats = getCommandBusStats();
+    for (int i = 0; i < SOURCE_COUNT; i++) TEST_ASSERT_EQUAL_UINT32(0, stats.posted[i]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.applied);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxDepth);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.avgLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.setpointsAccepted);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.setpointsStale);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.setpointsApplied);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_out_of_order_update_is_stale);
+    RUN_TEST(test_transports_do_not_evict_each_other);
+    RUN_TEST(test_same_id_on_two_transports_is_two_clients);
+    RUN_TEST(test_ack_record_survives_client_eviction);
+    RUN_TEST(test_rebound_ack_record_ignores_old_client);
+    RUN_TEST(test_concurrent_clients_and_control_task);
+    RUN_TEST(test_reset_zeroes_every_counter);
+    return UNITY_END();
+}
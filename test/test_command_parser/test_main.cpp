@@ -0,0 +1,268 @@
+// Shared command parser: grammar, malformed input, fuzzing against a
+// reference tokenizer, and throughput. Run with:
+//   pio test -e native -f test_command_parser -v
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "command_parser.h"
+#include "native_stubs.h"
+
+// Heap allocations made while parsing (must stay 0)
+static std::atomic<uint32_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+struct Captured {
+    char op;
+    float value;
+};
+
+static std::vector<Captured> captured;
+
+static void capture(const ParsedCommand& cmd, void* context) {
+    captured.push_back({ cmd.op, cmd.value });
+}
+
+static CommandParser parse(const char* text) {
+    captured.clear();
+    CommandParser parser(capture);
+    parser.feed(text, strlen(text));
+    parser.flush();
+    return parser;
+}
+
+void setUp(void) {
+    captured.reserve(4096);
+}
+
+void tearDown(void) {}
+
+void test_batched_commands(void) {
+    CommandParser parser = parse("S42.5;d,F r\tx\nC+-?f");
+    const char expected[] = { 'S', 'D', 'F', 'R', 'X', 'C', '+', '-', '?', 'f' };
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getErrorCount());
+    TEST_ASSERT_EQUAL(sizeof(expected), captured.size());
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        TEST_ASSERT_EQUAL_CHAR(expected[i], captured[i].op);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 42.5f, captured[0].value);
+}
+
+void test_number_ends_at_next_command(void) {
+    CommandParser parser = parse("S50D l3 p2");
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getErrorCount());
+    TEST_ASSERT_EQUAL(4, captured.size());
+    TEST_ASSERT_EQUAL_CHAR('S', captured[0].op);
+    TEST_ASSERT_EQUAL_CHAR('D', captured[1].op);
+    TEST_ASSERT_EQUAL_CHAR('L', captured[2].op);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, captured[2].value);
+    TEST_ASSERT_EQUAL_CHAR('P', captured[3].op);
+}
+
+void test_log_level_range(void) {
+    CommandParser parser = parse("L0 L5 L5.0");
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getErrorCount());
+    TEST_ASSERT_EQUAL(3, captured.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, captured[0].value);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.0f, captured[1].value);
+
+    parser = parse("L5.1 L6 L300 D");
+    TEST_ASSERT_EQUAL_UINT32(3, parser.getErrorCount());
+    TEST_ASSERT_EQUAL(1, captured.size());
+    TEST_ASSERT_EQUAL_CHAR('D', captured[0].op);
+}
+
+void test_split_across_feeds(void) {
+    captured.clear();
+    CommandParser parser(capture);
+    parser.feed("S4", 2);
+    TEST_ASSERT_TRUE(parser.hasPending());
+    parser.feed("2.5", 3);
+    parser.flush();
+    TEST_ASSERT_EQUAL(1, captured.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 42.5f, captured[0].value);
+}
+
+// A malformed token applies nothing, not even the part that looks like a command
+void test_malformed_token_applies_nothing(void) {
+    const char* malformed[] = { "S-5", "S5q", "Q+", "S", "S;", "S5.5.5", "S123456789", "L-1", "L6", "L300", "Sx1" };
+    for (const char* text : malformed) {
+        CommandParser parser = parse(text);
+        TEST_ASSERT_TRUE_MESSAGE(parser.getErrorCount() > 0, text);
+        TEST_ASSERT_EQUAL_MESSAGE(0, captured.size(), text);
+    }
+}
+
+void test_error_discards_only_up_to_separator(void) {
+    CommandParser parser = parse("S-5;D Q+ F");
+    TEST_ASSERT_EQUAL_UINT32(2, parser.getErrorCount());
+    TEST_ASSERT_EQUAL(2, captured.size());
+    TEST_ASSERT_EQUAL_CHAR('D', captured[0].op);
+    TEST_ASSERT_EQUAL_CHAR('F', captured[1].op);
+}
+
+void test_flush_ends_discarding(void) {
+    captured.clear();
+    CommandParser parser(capture);
+    parser.feed("S-", 2);
+    parser.flush();
+    parser.feed("+", 1);
+    parser.flush();
+    TEST_ASSERT_EQUAL(1, captured.size());
+    TEST_ASSERT_EQUAL_CHAR('+', captured[0].op);
+}
+
+// Reference model of the grammar: split at separators, accept a token only if
+// it is a sequence of at most COMMAND_PARSER_MAX_TOKEN_OPS commands with
+// well-formed numbers.
+static bool referenceToken(const std::string& token, std::vector<Captured>& out) {
+    std::vector<Captured> commands;
+    size_t i = 0;
+    while (i < token.size()) {
+        char c = token[i++];
+        char upper = (c == 'f') ? c : (char)(c & ~0x20);
+        if (c == '+' || c == '-' || c == '?' || c == 'f' || c == 'F' ||
+            upper == 'D' || upper == 'R' || upper == 'X' || upper == 'C') {
+            bool keepCase = c == '+' || c == '-' || c == '?' || c == 'f' || c == 'F';
+            commands.push_back({ keepCase ? c : upper, 0.0f });
+        } else if (upper == 'S' || upper == 'L' || upper == 'P') {
+            size_t start = i;
+            while (i < token.size() && ((token[i] >= '0' && token[i] <= '9') || token[i] == '.')) i++;
+            std::string number = token.substr(start, i - start);
+            if (number.empty() || number.size() > COMMAND_PARSER_MAX_NUMBER) return false;
+            char* end = nullptr;
+            float value = strtof(number.c_str(), &end);
+            if (end != number.c_str() + number.size()) return false;
+            if (upper == 'L' && value > LOG_LEVEL_TRACE) return false;
+            commands.push_back({ upper, value });
+        } else {
+            return false;
+        }
+    }
+    if (commands.size() > COMMAND_PARSER_MAX_TOKEN_OPS) return false;
+    out.insert(out.end(), commands.begin(), commands.end());
+    return true;
+}
+
+static const char ALPHABET[] = "SsLlPpDdRrFfXxCc+-?Qz0123456789..;, \n";
+
+void test_fuzz_matches_reference(void) {
+    std::mt19937 random(1234);
+    uint32_t accepted = 0, rejected = 0;
+    for (int round = 0; round < 20000; round++) {
+        std::string input;
+        int length = random() % 40;
+        for (int i = 0; i < length; i++) {
+            input += ALPHABET[random() % (sizeof(ALPHABET) - 1)];
+        }
+
+        std::vector<Captured> expected;
+        uint32_t expectedErrors = 0;
+        size_t pos = 0;
+        while (pos <= input.size()) {
+            size_t next = input.find_first_of(";, \t\r\n", pos);
+            if (next == std::string::npos) next = input.size();
+            std::string token = input.substr(pos, next - pos);
+            if (!token.empty()) {
+                if (referenceToken(token, expected)) {
+                    accepted++;
+                } else {
+                    expectedErrors++;
+                    rejected++;
+                }
+            }
+            pos = next + 1;
+        }
+
+        CommandParser parser = parse(input.c_str());
+        bool match = parser.getErrorCount() == expectedErrors && captured.size() == expected.size();
+        for (size_t i = 0; match && i < expected.size(); i++) {
+            match = captured[i].op == expected[i].op && captured[i].value == expected[i].value;
+        }
+        if (!match) {
+            char message[160];
+            snprintf(message, sizeof(message), "input \"%s\": %u errors, %u commands (expected %u, %u)",
+                input.c_str(), parser.getErrorCount(), (unsigned)captured.size(),
+                expectedErrors, (unsigned)expected.size());
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "fuzz: %u tokens accepted, %u rejected", accepted, rejected);
+    TEST_MESSAGE(message);
+}
+
+// Random bytes, including NUL and high bytes: must neither crash nor emit junk ops
+void test_fuzz_random_bytes(void) {
+    std::mt19937 random(99);
+    captured.clear();
+    CommandParser parser(capture);
+    uint8_t buffer[64];
+    for (int round = 0; round < 100000; round++) {
+        size_t length = random() % sizeof(buffer);
+        for (size_t i = 0; i < length; i++) buffer[i] = random();
+        parser.feed((const char*)buffer, length);
+        if (round % 7 == 0) parser.flush();
+        for (const Captured& cmd : captured) {
+            TEST_ASSERT_TRUE(strchr("+-?fFDRXCSLP", cmd.op) != nullptr);
+        }
+        captured.clear();
+    }
+}
+
+static uint32_t benchmarkCount = 0;
+
+static void countOnly(const ParsedCommand& cmd, void* context) {
+    benchmarkCount++;
+}
+
+void test_throughput_and_no_allocation(void) {
+    static const char batch[] = "S42.5;D;F;+;-;f;R;X;C;S0\n";
+    const int batchCommands = 10;
+    const int rounds = 200000;
+    CommandParser parser(countOnly);
+
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        parser.feed(batch, sizeof(batch) - 1);
+    }
+    parser.flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint32_t allocated = allocations;
+
+    char message[128];
+    snprintf(message, sizeof(message), "throughput: %.1f M commands/s, %.1f MB/s, %u allocations",
+        benchmarkCount / seconds / 1e6, rounds * (sizeof(batch) - 1) / seconds / 1e6, allocated);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)rounds * batchCommands, benchmarkCount);
+    TEST_ASSERT_EQUAL_UINT32(0, parser.getErrorCount());
+    TEST_ASSERT_EQUAL_UINT32(0, allocated);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batched_commands);
+    RUN_TEST(test_number_ends_at_next_command);
+    RUN_TEST(test_log_level_range);
+    RUN_TEST(test_split_across_feeds);
+    RUN_TEST(test_malformed_token_applies_nothing);
+    RUN_TEST(test_error_discards_only_up_to_separator);
+    RUN_TEST(test_flush_ends_discarding);
+    RUN_TEST(test_fuzz_matches_reference);
+    RUN_TEST(test_fuzz_random_bytes);
+    RUN_TEST(test_throughput_and_no_allocation);
+    return UNITY_END();
+}
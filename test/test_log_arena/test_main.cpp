@@ -0,0 +1,165 @@
+// Log record arena: retention and eviction, concurrent writers, and a
+// lines/s and heap benchmark against the String ring it replaced. Run with:
+//   pio test -e native -f test_log_arena -v
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logging.h"
+#include "native_stubs.h"
+
+static std::atomic<uint32_t> allocations(0);
+static std::atomic<uint64_t> allocatedBytes(0);
+
+void* operator new(size_t size) {
+    allocations++;
+    allocatedBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+void setUp(void) {
+    Logger.clearLogs();
+    Logger.setLevel(LOG_LEVEL_TRACE);
+}
+
+void tearDown(void) {}
+
+void test_records_keep_order_through_eviction(void) {
+    std::mt19937 random(3);
+    std::map<uint32_t, std::string> expected;
+    uint32_t seq = Logger.getNextSeq();
+
+    for (int i = 0; i < 50000; i++) {
+        std::string text;
+        int length = 1 + random() % 300;
+        for (int k = 0; k < length; k++) text += (char)('a' + random() % 26);
+        Logger.printf("%s\n", text.c_str());
+        // printf formats into MAX_LOG_MESSAGE_LENGTH bytes including the newline
+        expected[seq++] = text.substr(0, std::min(length, MAX_LOG_MESSAGE_LENGTH - 2));
+
+        if (i % 97 == 0) {
+            TEST_ASSERT_EQUAL_UINT32(seq, Logger.getNextSeq());
+            LogRecord record;
+            for (uint32_t s = Logger.getFirstSeq(); s < seq; s++) {
+                TEST_ASSERT_TRUE(Logger.readRecord(s, record));
+                TEST_ASSERT_EQUAL_UINT32(s, record.seq);
+                TEST_ASSERT_EQUAL_STRING(expected[s].c_str(), record.text);
+            }
+            TEST_ASSERT_FALSE(Logger.readRecord(seq, record));
+        }
+    }
+
+    LogStats stats = Logger.getStats();
+    TEST_ASSERT_LESS_OR_EQUAL(LOG_ARENA_SIZE, stats.bytesUsed);
+    TEST_ASSERT_LESS_OR_EQUAL(LOG_INDEX_SIZE, stats.records);
+    TEST_ASSERT_GREATER_THAN(0, stats.evicted);
+}
+
+// Several threads assemble lines from fragments at once; every record must
+// be one whole line from one writer, in that writer's order
+void test_concurrent_writers_do_not_interleave(void) {
+    const int writers = 4;
+    const int linesPerWriter = 20000;
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> bad(0);
+    std::atomic<bool> running(true);
+    uint32_t writtenBefore = Logger.getStats().written;
+
+    // A reader checks records while they are being written
+    std::thread reader([&]() {
+        int lastLine[writers];
+        for (int& line : lastLine) line = -1;
+        uint32_t seq = Logger.getFirstSeq();
+        LogRecord record;
+        while (running || seq < Logger.getNextSeq()) {
+            if (seq < Logger.getFirstSeq()) seq = Logger.getFirstSeq();    // Evicted meanwhile
+            if (seq >= Logger.getNextSeq() || !Logger.readRecord(seq, record)) continue;
+            int writer, line;
+            char tail[16];
+            if (sscanf(record.text, "writer %d line %d %15s", &writer, &line, tail) != 3 ||
+                writer < 0 || writer >= writers || strcmp(tail, "end") != 0 || line <= lastLine[writer]) {
+                bad++;
+            } else {
+                lastLine[writer] = line;
+            }
+            seq++;
+        }
+    });
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([w]() {
+            char number[16];
+            for (int line = 0; line < linesPerWriter; line++) {
+                Logger.write((const uint8_t*)"writer ", 7);
+                snprintf(number, sizeof(number), "%d", w);
+                Logger.write((const uint8_t*)number, strlen(number));
+                Logger.printf(" line %d", line);
+                Logger.write((const uint8_t*)" end\n", 5);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    running = false;
+    reader.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, bad.load());
+    TEST_ASSERT_EQUAL_UINT32(writers * linesPerWriter, Logger.getStats().written - writtenBefore);
+}
+
+// What the ring did before the arena: one heap String per line
+static std::string legacyRing[LOG_INDEX_SIZE];
+
+static void legacyLog(uint32_t index, const char* message) {
+    legacyRing[index % LOG_INDEX_SIZE] = std::to_string(millis()) + "ms: " + std::string(message);
+}
+
+void test_benchmark_lines_per_second(void) {
+    const int lines = 500000;
+    char message[96];
+
+    allocations = 0;
+    allocatedBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++) {
+        snprintf(message, sizeof(message), "Speed: %d.%d%% current, line %d of the benchmark run", i % 100, i % 10, i);
+        legacyLog(i, message);
+    }
+    double legacySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint32_t legacyAllocations = allocations;
+    uint64_t legacyBytes = allocatedBytes;
+
+    allocations = 0;
+    allocatedBytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++) {
+        Logger.printf("Speed: %d.%d%% current, line %d of the benchmark run\n", i % 100, i % 10, i);
+    }
+    double arenaSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint32_t arenaAllocations = allocations;
+
+    char report[200];
+    snprintf(report, sizeof(report),
+        "String ring: %.2f M lines/s, %.2f allocations/line (%.0f bytes); arena: %.2f M lines/s, %u allocations",
+        lines / legacySeconds / 1e6, (double)legacyAllocations / lines, (double)legacyBytes / lines,
+        lines / arenaSeconds / 1e6, arenaAllocations);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_EQUAL_UINT32(0, arenaAllocations);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_keep_order_through_eviction);
+    RUN_TEST(test_concurrent_writers_do_not_interleave);
+    RUN_TEST(test_benchmark_lines_per_second);
+    return UNITY_END();
+}
@@ -0,0 +1,100 @@
+// Deferred (binary) log records: formatting on read matches printf, and the
+// cost per call of LOG_FAST against immediate formatting. Run with:
+//   pio test -e native -f test_log_deferred -v
+#include <unity.h>
+#include <chrono>
+#include "logging.h"
+#include "native_stubs.h"
+
+void setUp(void) {
+    Logger.clearLogs();
+    Logger.setLevel(LOG_LEVEL_TRACE);
+}
+
+void tearDown(void) {}
+
+static void readNewest(LogRecord& record) {
+    TEST_ASSERT_TRUE(Logger.readRecord(Logger.getNextSeq() - 1, record));
+}
+
+void test_deferred_record_formats_like_printf(void) {
+    LogRecord record;
+    LOG_FAST(LOG_LEVEL_INFO, "🎯 Target speed set to: %.1f%%", 42.5f);
+    readNewest(record);
+    TEST_ASSERT_TRUE(record.deferred);
+    TEST_ASSERT_EQUAL_STRING("🎯 Target speed set to: 42.5%", record.text);
+
+    LOG_FAST(LOG_LEVEL_WARN, "int %d uint %u long %ld hex %x char %c str %s", -7, 7u, -123456L, 255u, 'z', "FORWARD");
+    readNewest(record);
+    TEST_ASSERT_EQUAL_STRING("int -7 uint 7 long -123456 hex ff char z str FORWARD", record.text);
+
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%lu %8.3f %-5s|", 4000000000UL, 3.14159, "ab");
+    LOG_FAST(LOG_LEVEL_INFO, "%lu %8.3f %-5s|", 4000000000UL, 3.14159, "ab");
+    readNewest(record);
+    TEST_ASSERT_EQUAL_STRING(expected, record.text);
+}
+
+// String arguments are copied (the caller's buffer may change before the read)
+void test_string_arguments_are_copied(void) {
+    char name[16] = "before";
+    LOG_FAST(LOG_LEVEL_INFO, "name %s", name);
+    strcpy(name, "after");
+    LogRecord record;
+    readNewest(record);
+    TEST_ASSERT_EQUAL_STRING("name before", record.text);
+}
+
+void test_runtime_level_filters_deferred_calls(void) {
+    uint32_t next = Logger.getNextSeq();
+    Logger.setLevel(LOG_LEVEL_WARN);
+    LOG_FAST(LOG_LEVEL_INFO, "filtered %d", 1);
+    TEST_ASSERT_EQUAL_UINT32(next, Logger.getNextSeq());
+    LOG_FAST(LOG_LEVEL_WARN, "kept %d", 2);
+    TEST_ASSERT_EQUAL_UINT32(next + 1, Logger.getNextSeq());
+}
+
+template <typename F>
+static double nanosecondsPerCall(int calls, F log) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) log(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+// The hot-path lines from rocket_state.cpp, both ways
+void test_benchmark_deferred_against_immediate(void) {
+    const int calls = 500000;
+    double immediate = nanosecondsPerCall(calls, [](int i) {
+        LOG_AT(LOG_LEVEL_INFO, "🎯 Target speed set to: %.1f%%", (float)(i % 1000) / 10.0f);
+        LOG_AT(LOG_LEVEL_INFO, "🎯 Target direction set to: %s", (i & 1) ? "FORWARD" : "REVERSE");
+    });
+    double deferred = nanosecondsPerCall(calls, [](int i) {
+        LOG_FAST(LOG_LEVEL_INFO, "🎯 Target speed set to: %.1f%%", (float)(i % 1000) / 10.0f);
+        LOG_FAST(LOG_LEVEL_INFO, "🎯 Target direction set to: %s", (i & 1) ? "FORWARD" : "REVERSE");
+    });
+
+    // Formatting moves to the reader: cost of turning deferred records into text
+    LogRecord record;
+    uint32_t first = Logger.getFirstSeq();
+    uint32_t count = Logger.getNextSeq() - first;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t seq = first; seq < first + count; seq++) {
+        Logger.readRecord(seq, record);
+    }
+    double readNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+
+    char report[160];
+    snprintf(report, sizeof(report), "per 2 log calls: immediate %.0f ns, deferred %.0f ns (%.1fx); read+format %.0f ns per record",
+        immediate, deferred, immediate / deferred, readNs);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN(immediate, deferred);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_deferred_record_formats_like_printf);
+    RUN_TEST(test_string_arguments_are_copied);
+    RUN_TEST(test_runtime_level_filters_deferred_calls);
+    RUN_TEST(test_benchmark_deferred_against_immediate);
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+// RocketState snapshot publishing: version only moves at the published
+// resolution, and readers on other threads never see a mixed snapshot.
+// Run with: pio test -e native -f test_rocket_state
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "rocket_state.h"
+#include "motor_control.h"
+#include "native_stubs.h"
+
+void setUp(void) {
+    initRocketState();
+}
+
+void tearDown(void) {}
+
+void test_publish_skips_unchanged_state(void) {
+    uint32_t version = getRocketStateSnapshot().version;
+    publishRocketState();
+    publishRocketState();
+    TEST_ASSERT_EQUAL_UINT32(version, getRocketStateSnapshot().version);
+
+    rocketState.targetSpeed = 50.0f;
+    publishRocketState();
+    RocketStateSnapshot snapshot = getRocketStateSnapshot();
+    TEST_ASSERT_EQUAL_UINT32(version + 1, snapshot.version);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, snapshot.targetSpeed);
+}
+
+// The acceleration curve and velocity integration creep by tiny amounts on
+// every 2 ms tick long after a change; that must not count as a change.
+void test_sub_resolution_creep_keeps_version(void) {
+    rocketState.currentSpeed = 42.0f;
+    rocketState.approximateVelocity = 0.42f;
+    publishRocketState();
+    uint32_t version = getRocketStateSnapshot().version;
+
+    for (int tick = 0; tick < 1000; tick++) {
+        rocketState.currentSpeed += 0.00004f;
+        rocketState.approximateVelocity += 0.000004f;
+        publishRocketState();
+    }
+    TEST_ASSERT_EQUAL_UINT32(version, getRocketStateSnapshot().version);
+
+    // A full 0.1 % step is published
+    rocketState.currentSpeed = 42.1f;
+    publishRocketState();
+    TEST_ASSERT_EQUAL_UINT32(version + 1, getRocketStateSnapshot().version);
+
+    // ... and so is 0.01 of velocity
+    rocketState.approximateVelocity = 0.44f;
+    publishRocketState();
+    TEST_ASSERT_EQUAL_UINT32(version + 2, getRocketStateSnapshot().version);
+}
+
+void test_flag_change_is_published(void) {
+    uint32_t version = getRocketStateSnapshot().version;
+    rocketState.firingThrusters = true;
+    publishRocketState();
+    TEST_ASSERT_EQUAL_UINT32(version + 1, getRocketStateSnapshot().version);
+    TEST_ASSERT_TRUE(getRocketStateSnapshot().firingThrusters);
+}
+
+// One control task tick (rtos_tasks.cpp): 2 ms of simulated time, the motor
+// model, then publish. Returns how many times the version moved.
+static uint32_t runControlTask(uint32_t seconds) {
+    uint32_t version = getRocketStateSnapshot().version;
+    uint32_t changes = 0;
+    for (uint32_t tick = 0; tick < seconds * 500; tick++) {
+        nativeAdvanceClock(2);
+        updateMotorControl();
+        publishRocketState();
+        uint32_t now = getRocketStateSnapshot().version;
+        if (now != version) changes++;
+        version = now;
+    }
+    return changes;
+}
+
+// /api/state's ETag is the state version, so a device left alone must hold it:
+// run the real motor model through a ramp and a stop, then check the version
+// stays put once the velocity estimate has settled at its published resolution.
+void test_idle_device_keeps_version(void) {
+    rocketState.lastSpeedUpdate = millis();
+    TEST_ASSERT_EQUAL_UINT32(0, runControlTask(60));
+
+    setEnabled(true);
+    updateTargetSpeed(60.0f);
+    uint32_t ramp = runControlTask(60);
+    TEST_ASSERT_TRUE(ramp > 0);
+    TEST_ASSERT_TRUE(ramp < 60 * 500 / 4);
+
+    setEnabled(false);
+    uint32_t settling = runControlTask(1200);
+    uint32_t idle = runControlTask(300);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u versions in a 60 s ramp, %u while stopping, %u idle over 300 s",
+        ramp, settling, idle);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, idle);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, getRocketStateSnapshot().currentSpeed);
+}
+
+// Writer (the "control task") publishes states whose fields all follow one
+// counter; readers check each snapshot for fields from different writes.
+void test_no_torn_snapshots_under_load(void) {
+    const int readerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+    std::atomic<uint64_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&]() {
+            uint32_t lastVersion = 0;
+            uint64_t count = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                RocketStateSnapshot snapshot = getRocketStateSnapshot();
+                bool odd = snapshot.enabled;
+                if (snapshot.currentSpeed != snapshot.targetSpeed ||
+                    fabsf(snapshot.approximateVelocity * 10.0f - snapshot.targetSpeed) > 0.01f ||
+                    snapshot.firingThrusters != odd ||
+                    snapshot.currentDirection == odd ||
+                    snapshot.targetDirection == odd) {
+                    torn++;
+                }
+                if (snapshot.version < lastVersion) backwards++;
+                lastVersion = snapshot.version;
+                count++;
+            }
+            reads += count;
+        });
+    }
+
+    uint32_t published = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    for (uint32_t k = 1; std::chrono::steady_clock::now() < end; k++) {
+        bool odd = k & 1;
+        float speed = (k % 1000) / 10.0f;
+        rocketState.targetSpeed = speed;
+        rocketState.currentSpeed = speed;
+        rocketState.approximateVelocity = speed / 10.0f;
+        rocketState.enabled = odd;
+        rocketState.firingThrusters = odd;
+        rocketState.currentDirection = !odd;
+        rocketState.targetDirection = !odd;
+        publishRocketState();
+        published++;
+    }
+    running = false;
+    for (std::thread& reader : readers) reader.join();
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u publishes, %llu snapshots on %d readers, %u torn",
+        published, (unsigned long long)reads.load(), readerCount, torn.load());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_publish_skips_unchanged_state);
+    RUN_TEST(test_sub_resolution_creep_keeps_version);
+    RUN_TEST(test_flag_change_is_published);
+    RUN_TEST(test_idle_device_keeps_version);
+    RUN_TEST(test_no_torn_snapshots_under_load);
+    return UNITY_END();
+}
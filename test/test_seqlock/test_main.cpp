@@ -0,0 +1,100 @@
+// SeqLock stress test: one writer, several readers on other threads, every
+// copy checked for tearing. Run with: pio test -e native -f test_seqlock
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "seqlock.h"
+#include "native_stubs.h"
+
+// Every field is derived from the same counter, so a mixed copy shows up
+struct Payload {
+    uint32_t counter;
+    uint32_t words[14];
+    uint32_t checksum;
+};
+
+static Payload makePayload(uint32_t counter) {
+    Payload payload;
+    payload.counter = counter;
+    payload.checksum = 0;
+    for (int i = 0; i < 14; i++) {
+        payload.words[i] = counter * 2654435761u + i;
+        payload.checksum ^= payload.words[i];
+    }
+    return payload;
+}
+
+static bool isConsistent(const Payload& payload) {
+    uint32_t checksum = 0;
+    for (int i = 0; i < 14; i++) {
+        if (payload.words[i] != payload.counter * 2654435761u + i) return false;
+        checksum ^= payload.words[i];
+    }
+    return checksum == payload.checksum;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_read_returns_last_write(void) {
+    SeqLock<Payload> lock;
+    TEST_ASSERT_EQUAL_UINT32(0, lock.writeCount());
+    lock.write(makePayload(7));
+    lock.write(makePayload(8));
+    Payload copy = lock.read();
+    TEST_ASSERT_EQUAL_UINT32(8, copy.counter);
+    TEST_ASSERT_TRUE(isConsistent(copy));
+    TEST_ASSERT_EQUAL_UINT32(2, lock.writeCount());
+}
+
+void test_no_torn_reads_under_concurrent_writes(void) {
+    static SeqLock<Payload> lock;
+    lock.write(makePayload(0));
+
+    const int readerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+    std::atomic<uint64_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&]() {
+            uint32_t last = 0;
+            uint64_t count = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                Payload copy = lock.read();
+                if (!isConsistent(copy)) torn++;
+                if (copy.counter < last) backwards++;
+                last = copy.counter;
+                count++;
+            }
+            reads += count;
+        });
+    }
+
+    uint32_t writes = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < end) {
+        lock.write(makePayload(++writes));
+    }
+    running = false;
+    for (std::thread& reader : readers) reader.join();
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u writes, %llu reads on %d readers, %u torn",
+        writes, (unsigned long long)reads.load(), readerCount, torn.load());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_EQUAL_UINT32(writes + 1, lock.writeCount());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_returns_last_write);
+    RUN_TEST(test_no_torn_reads_under_concurrent_writes);
+    return UNITY_END();
+}
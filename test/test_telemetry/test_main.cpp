@@ -0,0 +1,149 @@
+// Telemetry hub: frames change only with their quantized fields, the
+// dispatcher spots a change whatever the seq did, and a reused subscriber slot
+// never pairs one subscription's callback with another's context.
+// Run with: pio test -e native -f test_telemetry
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "telemetry.h"
+#include "rocket_state.h"
+#include "native_stubs.h"
+
+struct Counter {
+    uint32_t calls;
+    TelemetryFrame last;
+};
+
+static void countFrame(const TelemetryFrame& frame, void* context) {
+    Counter* counter = (Counter*)context;
+    counter->calls++;
+    counter->last = frame;
+}
+
+static const TelemetrySubscription EVERY_CHANGE = { 0, 0, 0, 0, TELEMETRY_FIELD_ALL };
+
+static void publish() {
+    publishRocketState();
+    updateTelemetry();
+}
+
+void setUp(void) {
+    initRocketState();
+    updateTelemetry();
+}
+
+void tearDown(void) {}
+
+void test_seq_counts_frame_changes(void) {
+    rocketState.targetSpeed = 20.0f;
+    publish();
+    uint16_t seq = getTelemetryFrame().seq;
+
+    // Below the frame's resolution: same frame
+    rocketState.targetSpeed = 20.04f;
+    publish();
+    TEST_ASSERT_EQUAL_UINT16(seq, getTelemetryFrame().seq);
+
+    rocketState.targetSpeed = 20.1f;
+    publish();
+    TEST_ASSERT_EQUAL_UINT16(seq + 1, getTelemetryFrame().seq);
+    TEST_ASSERT_EQUAL_UINT16(201, getTelemetryFrame().targetSpeed);
+
+    rocketState.firingThrusters = true;
+    publish();
+    TEST_ASSERT_EQUAL_UINT16(seq + 2, getTelemetryFrame().seq);
+}
+
+void test_idle_hub_pushes_nothing(void) {
+    Counter counter = {};
+    int id = subscribeTelemetry("test", EVERY_CHANGE, countFrame, &counter);
+    TEST_ASSERT_TRUE(id >= 0);
+
+    for (int tick = 0; tick < 1000; tick++) {
+        publish();
+        dispatchTelemetry();
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, counter.calls);     // The first frame only
+
+    rocketState.targetSpeed = 33.0f;
+    publish();
+    dispatchTelemetry();
+    TEST_ASSERT_EQUAL_UINT32(2, counter.calls);
+    TEST_ASSERT_EQUAL_UINT16(330, counter.last.targetSpeed);
+    unsubscribeTelemetry(id);
+}
+
+// 65536 frame changes between two dispatches bring seq back to the same value
+void test_change_detected_across_seq_wrap(void) {
+    Counter counter = {};
+    int id = subscribeTelemetry("test", EVERY_CHANGE, countFrame, &counter);
+    dispatchTelemetry();
+    uint16_t seq = getTelemetryFrame().seq;
+    uint32_t calls = counter.calls;
+
+    for (uint32_t k = 1; k <= 65536; k++) {
+        rocketState.targetSpeed = (k % 1000) / 10.0f;
+        publish();
+    }
+    TEST_ASSERT_EQUAL_UINT16(seq, getTelemetryFrame().seq);
+
+    dispatchTelemetry();
+    TEST_ASSERT_EQUAL_UINT32(calls + 1, counter.calls);
+    TEST_ASSERT_EQUAL_UINT16(536, counter.last.targetSpeed);
+    unsubscribeTelemetry(id);
+}
+
+// One thread keeps re-subscribing the slot with alternating callback/context
+// pairs while the dispatcher pushes to it; every call must get its own pair.
+static std::atomic<uint32_t> mismatches(0);
+static std::atomic<uint32_t> pushes(0);
+static int contextA, contextB;
+
+static void callbackA(const TelemetryFrame&, void* context) {
+    if (context != &contextA) mismatches++;
+    pushes++;
+}
+
+static void callbackB(const TelemetryFrame&, void* context) {
+    if (context != &contextB) mismatches++;
+    pushes++;
+}
+
+void test_slot_reuse_keeps_callback_and_context_paired(void) {
+    std::atomic<bool> running(true);
+    std::atomic<int> currentId(subscribeTelemetry("a", EVERY_CHANGE, callbackA, &contextA));
+    mismatches = 0;
+    pushes = 0;
+
+    std::thread subscriber([&]() {
+        for (uint32_t k = 0; running.load(std::memory_order_relaxed); k++) {
+            unsubscribeTelemetry(currentId.load());
+            currentId = (k & 1) ? subscribeTelemetry("a", EVERY_CHANGE, callbackA, &contextA)
+                                : subscribeTelemetry("b", EVERY_CHANGE, callbackB, &contextB);
+        }
+    });
+
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < end) {
+        requestTelemetry(currentId.load());
+        dispatchTelemetry();
+    }
+    running = false;
+    subscriber.join();
+    unsubscribeTelemetry(currentId.load());
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u pushes during slot reuse, %u mismatched", pushes.load(), mismatches.load());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(pushes.load() > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, mismatches.load());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_seq_counts_frame_changes);
+    RUN_TEST(test_idle_hub_pushes_nothing);
+    RUN_TEST(test_change_detected_across_seq_wrap);
+    RUN_TEST(test_slot_reuse_keeps_callback_and_context_paired);
+    return UNITY_END();
+}
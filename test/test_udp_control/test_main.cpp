@@ -0,0 +1,200 @@
+// UDP control channel (the real udp_control.cpp over an in-memory socket):
+// a client on a link that drops and reorders datagrams still lands its last
+// setpoint, never moves the target backwards, and going silent stops the rocket.
+// Run with: pio test -e native -f test_udp_control
+#include <unity.h>
+#include <random>
+#include <deque>
+#include <AsyncUDP.h>
+#include "udp_control.h"
+#include "command_bus.h"
+#include "rocket_state.h"
+#include "native_stubs.h"
+
+static const IPAddress CLIENT_IP(192, 168, 1, 20);
+static const uint16_t CLIENT_PORT = 50000;
+static const uint32_t CLIENT_ID = 0xC0FFEE;
+
+static std::mt19937 rng(1234);
+
+static bool lost(float loss) {
+    return std::uniform_real_distribution<float>(0.0f, 1.0f)(rng) < loss;
+}
+
+static UdpSetpointPacket makeSetpoint(uint32_t seq, uint16_t speedTenths, bool fire) {
+    UdpSetpointPacket packet = {};
+    packet.magic = UDP_PACKET_MAGIC;
+    packet.version = UDP_PACKET_VERSION;
+    packet.type = UDP_PACKET_SETPOINT;
+    packet.clientId = CLIENT_ID;
+    packet.seq = seq;
+    packet.clientTimeMs = seq * 20;
+    packet.speedTenths = speedTenths;
+    packet.flags = UDP_SETPOINT_FORWARD | (fire ? UDP_SETPOINT_FIRE : 0);
+    return packet;
+}
+
+static void deliver(const UdpSetpointPacket& packet) {
+    nativeAsyncUdp()->receive(&packet, sizeof(packet), CLIENT_IP, CLIENT_PORT);
+}
+
+struct LinkRun {
+    uint32_t sent = 0;
+    uint32_t dropped = 0;
+    uint32_t reordered = 0;
+    uint32_t states = 0;
+    uint32_t ackSeq = 0;
+    bool targetWentBack = false;
+};
+
+// Control task every 2 ms, network task every 10 ms, a client setpoint every
+// 20 ms; loss applies to both directions, and some setpoints arrive late.
+static void runLink(LinkRun& run, uint32_t ms, float loss, bool clientSending,
+                    uint32_t& seq, uint16_t rampTo, bool fire) {
+    std::deque<UdpSetpointPacket> delayed;
+    uint32_t firstSeq = seq;
+    float lastTarget = getTargetSpeedPercent();
+
+    for (uint32_t t = 2; t <= ms; t += 2) {
+        nativeAdvanceClock(2);
+
+        if (clientSending && t % 20 == 0) {
+            seq++;
+            UdpSetpointPacket packet = makeSetpoint(seq, std::min<uint32_t>((seq - firstSeq) * 10, rampTo), fire);
+            run.sent++;
+            if (lost(loss)) {
+                run.dropped++;
+            } else if (lost(0.1f)) {
+                delayed.push_back(packet);      // Overtaken by the next ones
+            } else {
+                deliver(packet);
+            }
+            if (delayed.size() > 2) {
+                deliver(delayed.front());
+                delayed.pop_front();
+                run.reordered++;
+            }
+        }
+
+        processCommands();
+        float target = getTargetSpeedPercent();
+        if (clientSending && target < lastTarget) run.targetWentBack = true;
+        lastTarget = target;
+
+        if (t % 10 == 0) {
+            AsyncUDP* udp = nativeAsyncUdp();
+            udp->sent.clear();
+            updateUdpControl();
+            for (const NativeDatagram& datagram : udp->sent) {
+                if (lost(loss) || datagram.data.size() != sizeof(UdpStatePacket)) continue;
+                UdpStatePacket state;
+                memcpy(&state, datagram.data.data(), sizeof(state));
+                run.states++;
+                if (state.ackSeq > run.ackSeq) run.ackSeq = state.ackSeq;
+            }
+        }
+    }
+}
+
+void setUp(void) {
+    initRocketState();
+    initCommandBus();
+    initUdpControl();
+    setEnabled(true);
+}
+
+void tearDown(void) {}
+
+void test_malformed_datagram_is_counted(void) {
+    UdpControlStats before = getUdpControlStats();
+    UdpSetpointPacket packet = makeSetpoint(1, 100, false);
+    packet.magic = 0;
+    deliver(packet);
+    nativeAsyncUdp()->receive(&packet, sizeof(packet) - 1, CLIENT_IP, CLIENT_PORT);
+    TEST_ASSERT_EQUAL_UINT32(before.malformed + 2, getUdpControlStats().malformed);
+    TEST_ASSERT_EQUAL_UINT32(before.received, getUdpControlStats().received);
+}
+
+// 20 % loss each way plus late datagrams: ramp to 60 %, hold, then go silent
+void test_lossy_link_lands_last_setpoint_and_failsafe(void) {
+    UdpControlStats before = getUdpControlStats();
+    LinkRun run;
+    uint32_t seq = 1000;
+
+    runLink(run, 3000, 0.2f, true, seq, 600, true);
+    TEST_ASSERT_FALSE(run.targetWentBack);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f, getTargetSpeedPercent());
+    TEST_ASSERT_TRUE(isFiringThrusters());
+    // The echo trails the client by at most the datagrams still in flight or lost
+    TEST_ASSERT_TRUE(seq - run.ackSeq < 5);
+
+    UdpControlStats during = getUdpControlStats();
+    char message[160];
+    snprintf(message, sizeof(message), "%u setpoints, %u dropped, %u late (%u stale), %u state datagrams received",
+        run.sent, run.dropped, run.reordered, during.stale - before.stale, run.states);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(run.dropped > 0);
+    TEST_ASSERT_TRUE(during.stale > before.stale);
+
+    // Client falls silent: one failsafe stop within the timeout
+    runLink(run, UDP_CONTROL_TIMEOUT_MS + 100, 0.2f, false, seq, 600, true);
+    TEST_ASSERT_EQUAL_UINT32(before.failsafes + 1, getUdpControlStats().failsafes);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, getTargetSpeedPercent());
+    TEST_ASSERT_FALSE(isFiringThrusters());
+    TEST_ASSERT_EQUAL_UINT8(0, getUdpControlStats().clients);
+}
+
+// An engaged client keeps its slot: a newcomer takes an idle slot or is refused
+void test_engaged_clients_are_not_evicted(void) {
+    const IPAddress otherIp(192, 168, 1, 21);
+    UdpControlStats before = getUdpControlStats();
+    UdpSetpointPacket first = makeSetpoint(1, 300, true);
+    UdpSetpointPacket second = makeSetpoint(1, 400, false);
+    UdpSetpointPacket third = makeSetpoint(1, 500, false);
+    second.clientId = CLIENT_ID + 1;
+    third.clientId = CLIENT_ID + 2;
+
+    deliver(first);
+    nativeAsyncUdp()->receive(&second, sizeof(second), otherIp, CLIENT_PORT);
+    processCommands();
+    TEST_ASSERT_EQUAL_UINT8(2, getUdpControlStats().clients);
+
+    // Both slots engaged: the third client is refused and changes nothing
+    nativeAsyncUdp()->receive(&third, sizeof(third), otherIp, CLIENT_PORT + 1);
+    processCommands();
+    UdpControlStats during = getUdpControlStats();
+    TEST_ASSERT_EQUAL_UINT32(before.refused + 1, during.refused);
+    TEST_ASSERT_EQUAL_UINT32(before.received + 2, during.received);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.0f, getTargetSpeedPercent());
+
+    // The second client idles: its slot goes to the newcomer, the first keeps its own
+    nativeAdvanceClock(20);
+    second.seq = 2;
+    second.clientTimeMs += 20;
+    second.speedTenths = 0;
+    nativeAsyncUdp()->receive(&second, sizeof(second), otherIp, CLIENT_PORT);
+    third.seq = 2;
+    third.clientTimeMs += 20;
+    nativeAsyncUdp()->receive(&third, sizeof(third), otherIp, CLIENT_PORT + 1);
+    processCommands();
+    UdpControlStats after = getUdpControlStats();
+    TEST_ASSERT_EQUAL_UINT32(during.refused, after.refused);
+    TEST_ASSERT_EQUAL_UINT32(during.received + 2, after.received);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, getTargetSpeedPercent());
+
+    // The first client still gets its failsafe stop when it goes silent
+    nativeAdvanceClock(UDP_CONTROL_TIMEOUT_MS + 10);
+    updateUdpControl();
+    processCommands();
+    TEST_ASSERT_EQUAL_UINT32(before.failsafes + 2, getUdpControlStats().failsafes);
+    TEST_ASSERT_FALSE(isFiringThrusters());
+    TEST_ASSERT_EQUAL_UINT8(0, getUdpControlStats().clients);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_malformed_datagram_is_counted);
+    RUN_TEST(test_lossy_link_lands_last_setpoint_and_failsafe);
+    RUN_TEST(test_engaged_clients_are_not_evicted);
+    return UNITY_END();
+}
@@ -0,0 +1,98 @@
+"""Gzip the static web UI into include/web_assets_data.h.
+
+Runs as a PlatformIO pre-build script (extra_scripts = pre:tools/embed_web_assets.py)
+and can also be run by hand: python tools/embed_web_assets.py
+
+Each asset is stored gzipped in flash and served as-is with Content-Encoding: gzip.
+The ETag is a hash of the compressed bytes, so it only changes with the content.
+The header is only rewritten when its content changes, to avoid needless rebuilds.
+"""
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+OUTPUT = os.path.join("include", "web_assets_data.h")
+
+# HTML and the service worker revalidate on every load (a cheap 304 while the
+# ETag matches); icons and the manifest are cached for a day.
+REVALIDATE = "no-cache"
+LONG_LIVED = "public, max-age=86400"
+
+# (URL path, source file, content type, Cache-Control)
+ASSETS = [
+    ("/", "web/control.html", "text/html; charset=utf-8", REVALIDATE),
+    ("/app/", "docs/index.html", "text/html; charset=utf-8", REVALIDATE),
+    ("/app/sw.js", "docs/sw.js", "text/javascript", REVALIDATE),
+    ("/app/manifest.json", "docs/manifest.json", "application/manifest+json", LONG_LIVED),
+    ("/app/icon-192.svg", "docs/icon-192.svg", "image/svg+xml", LONG_LIVED),
+    ("/app/icon-512.svg", "docs/icon-512.svg", "image/svg+xml", LONG_LIVED),
+]
+
+
+def c_bytes(data, per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def render():
+    out = [
+        "// Generated by tools/embed_web_assets.py - do not edit",
+        "#ifndef WEB_ASSETS_DATA_H",
+        "#define WEB_ASSETS_DATA_H",
+        "",
+        "#include <pgmspace.h>",
+        '#include "web_assets.h"',
+        "",
+    ]
+    entries = []
+    total_raw = total_gz = 0
+    for index, (path, source, content_type, cache_control) in enumerate(ASSETS):
+        with open(os.path.join(PROJECT_DIR, source), "rb") as f:
+            raw = f.read()
+        # mtime=0 keeps the output (and the ETag) reproducible
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(packed).hexdigest()[:16]
+        total_raw += len(raw)
+        total_gz += len(packed)
+
+        out.append("// %s <- %s (%d -> %d bytes)" % (path, source, len(raw), len(packed)))
+        out.append("static const uint8_t WEB_ASSET_%d[] PROGMEM = {" % index)
+        out.append(c_bytes(packed))
+        out.append("};")
+        out.append("")
+        entries.append('    { "%s", "%s", "%s", "\\"%s\\"", WEB_ASSET_%d, %d },'
+                       % (path, content_type, cache_control, etag, index, len(packed)))
+
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    out.extend(entries)
+    out.append("};")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_DATA_H")
+    out.append("")
+    return "\n".join(out), total_raw, total_gz
+
+
+def main():
+    text, total_raw, total_gz = render()
+    path = os.path.join(PROJECT_DIR, OUTPUT)
+    try:
+        with open(path, "r") as f:
+            if f.read() == text:
+                return
+    except OSError:
+        pass
+    with open(path, "w") as f:
+        f.write(text)
+    print("Web assets: %d files, %d -> %d bytes gzipped" % (len(ASSETS), total_raw, total_gz))
+
+
+main()
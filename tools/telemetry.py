@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Decoder for the Space Tornado binary TelemetryFrame (include/telemetry.h).
+
+The same 14-byte frame is served at GET /api/telemetry. BLE status
+notifications append the ack of the central's newest binary command write
+(include/ble_interface.h); encode_command() builds such writes.
+
+    import telemetry
+    state = telemetry.decode(frame_bytes)
+    write = telemetry.encode_command(7, speed=50.0, forward=True, fire=True)
+
+    python3 tools/telemetry.py http://spacetornado.local   # fetch and print
+    python3 tools/telemetry.py 011d7111d2040000f40158021a00
+"""
+
+import struct
+import sys
+import urllib.request
+
+FRAME_VERSION = 1
+FRAME = struct.Struct("<BBHIHHH")
+ACK = struct.Struct("<HB")                      # After the frame in BLE notifications
+
+FORWARD = 1 << 0
+TARGET_FORWARD = 1 << 1
+ENABLED = 1 << 2
+ACTIVE = 1 << 3
+FIRING = 1 << 4
+EMERGENCY_STOP = 1 << 5
+
+COMMAND_VERSION = 0x01
+OP_SET_SPEED = 0x01
+OP_DIRECTION = 0x02
+OP_FIRE = 0x03
+OP_ADJUST_SPEED = 0x04
+OP_EMERGENCY_STOP = 0x05
+OP_CLEAR_EMERGENCY_STOP = 0x06
+OP_STATUS = 0x07
+
+ACK_STATUS = {0: "none", 1: "applied", 2: "stale", 3: "rejected", 4: "busy"}
+
+
+def decode(data):
+    """Return the frame as a dict, with the ack if this is a BLE notification.
+    Other trailing bytes (newer fields) are ignored."""
+    if len(data) < FRAME.size:
+        raise ValueError(f"telemetry frame too short: {len(data)} bytes")
+    version, flags, seq, timestamp_ms, current, target, velocity = FRAME.unpack_from(data)
+    if version != FRAME_VERSION:
+        raise ValueError(f"unsupported telemetry frame version {version}")
+    state = {
+        "seq": seq,
+        "timestampMs": timestamp_ms,
+        "currentSpeed": current / 10.0,
+        "targetSpeed": target / 10.0,
+        "velocity": velocity / 100.0,
+        "direction": bool(flags & FORWARD),
+        "targetDirection": bool(flags & TARGET_FORWARD),
+        "enabled": bool(flags & ENABLED),
+        "active": bool(flags & ACTIVE),
+        "firingThrusters": bool(flags & FIRING),
+        "emergencyStop": bool(flags & EMERGENCY_STOP),
+    }
+    if len(data) >= FRAME.size + ACK.size:
+        ack_seq, ack_status = ACK.unpack_from(data, FRAME.size)
+        state["ackSeq"] = ack_seq
+        state["ackStatus"] = ACK_STATUS.get(ack_status, ack_status)
+    return state
+
+
+def encode_command(seq, speed=None, forward=None, fire=None, adjust=None,
+                   emergency_stop=False, clear_emergency_stop=False, status=False):
+    """Binary command write for the BLE command characteristic.
+    The device applies adjust/stop/clear first, then speed, direction and fire together."""
+    data = bytearray(struct.pack("<BH", COMMAND_VERSION, seq & 0xFFFF))
+    if emergency_stop:
+        data.append(OP_EMERGENCY_STOP)
+    if clear_emergency_stop:
+        data.append(OP_CLEAR_EMERGENCY_STOP)
+    if adjust is not None:
+        data += struct.pack("<Bh", OP_ADJUST_SPEED, int(round(adjust * 10)))
+    if speed is not None:
+        data += struct.pack("<BH", OP_SET_SPEED, int(round(max(0.0, min(100.0, speed)) * 10)))
+    if forward is not None:
+        data += struct.pack("<BB", OP_DIRECTION, 1 if forward else 0)
+    if fire is not None:
+        data += struct.pack("<BB", OP_FIRE, 1 if fire else 0)
+    if status:
+        data.append(OP_STATUS)
+    return bytes(data)
+
+
+def fetch(base_url, timeout=2.0):
+    with urllib.request.urlopen(base_url.rstrip("/") + "/api/telemetry", timeout=timeout) as response:
+        return decode(response.read())
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+    arg = sys.argv[1]
+    state = fetch(arg) if arg.startswith("http") else decode(bytes.fromhex(arg))
+    for key, value in state.items():
+        print(f"{key}: {value}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
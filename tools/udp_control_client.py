@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Reference client for the Space Tornado UDP control channel.
+
+Sends setpoint datagrams at a fixed rate (each one doubles as the heartbeat),
+reads the state datagrams the device sends back and reports round-trip latency.
+
+    python3 tools/udp_control_client.py spacetornado.local --speed 30 --duration 10
+    python3 tools/udp_control_client.py --loopback --loss 0.2
+
+--loss drops that fraction of datagrams in both directions to show behavior on a
+lossy link. --loopback runs against a Python model of the device on 127.0.0.1
+(sequence ordering, state rate, failsafe stop) and checks that the final setpoint
+arrived and that going silent stops it. That exercises this client only; the
+firmware side is covered by the test_udp_control host suite (pio test -e native).
+
+Packet layouts match include/udp_control.h (little-endian).
+"""
+
+import argparse
+import math
+import random
+import socket
+import statistics
+import struct
+import sys
+import threading
+import time
+
+MAGIC = 0x5453
+VERSION = 1
+TYPE_SETPOINT = 1
+TYPE_STATE = 2
+
+SETPOINT_FORWARD = 1 << 0
+SETPOINT_FIRE = 1 << 1
+
+STATE_FORWARD = 1 << 0
+STATE_TARGET_FORWARD = 1 << 1
+STATE_ENABLED = 1 << 2
+STATE_FIRING = 1 << 3
+STATE_EMERGENCY_STOP = 1 << 4
+
+SETPOINT = struct.Struct("<HBBIIIHBB")          # 20 bytes
+STATE = struct.Struct("<HBBIIHHIIHHB3x")        # 32 bytes
+
+DEFAULT_PORT = 4210
+STATE_INTERVAL_S = 0.020                        # UDP_STATE_INTERVAL_MS
+CONTROL_TIMEOUT_S = 0.500                       # UDP_CONTROL_TIMEOUT_MS
+
+
+def now_ms():
+    return int(time.monotonic() * 1000) & 0xFFFFFFFF
+
+
+def seq_newer(a, b):
+    """Wrap-safe a > b for 32-bit counters."""
+    return 0 < ((a - b) & 0xFFFFFFFF) < 0x80000000
+
+
+class SimulatedDevice(threading.Thread):
+    """Python model of the device side, for loopback self-checks (not the firmware)."""
+
+    def __init__(self, port=0):
+        super().__init__(daemon=True)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(("127.0.0.1", port))
+        self.sock.settimeout(STATE_INTERVAL_S / 2)
+        self.port = self.sock.getsockname()[1]
+        self.running = True
+        self.target_tenths = 0
+        self.flags = SETPOINT_FORWARD
+        self.version = 0
+        self.clients = {}           # client id -> dict
+        self.failsafes = 0
+        self.stale = 0
+
+    def run(self):
+        last_state = 0.0
+        while self.running:
+            try:
+                data, addr = self.sock.recvfrom(64)
+                self.on_packet(data, addr)
+            except socket.timeout:
+                pass
+            now = time.monotonic()
+            self.expire(now)
+            if now - last_state >= STATE_INTERVAL_S:
+                last_state = now
+                self.send_state(now)
+
+    def on_packet(self, data, addr):
+        if len(data) != SETPOINT.size:
+            return
+        magic, version, kind, client_id, seq, client_ms, speed, flags, _ = SETPOINT.unpack(data)
+        if magic != MAGIC or version != VERSION or kind != TYPE_SETPOINT:
+            return
+        client = self.clients.get(client_id)
+        if client and not (seq_newer(seq, client["seq"]) and not seq_newer(client["t"], client_ms)):
+            self.stale += 1
+            client["heard"] = time.monotonic()
+            return
+        self.clients[client_id] = {"addr": addr, "seq": seq, "t": client_ms, "heard": time.monotonic(),
+                                   "accepted": time.monotonic(), "engaged": speed > 0 or flags & SETPOINT_FIRE}
+        if speed != self.target_tenths or flags != self.flags:
+            self.target_tenths = min(speed, 1000)
+            self.flags = flags
+            self.version += 1
+
+    def expire(self, now):
+        for client_id, client in list(self.clients.items()):
+            if now - client["heard"] > CONTROL_TIMEOUT_S:
+                del self.clients[client_id]
+                if client["engaged"]:
+                    self.failsafes += 1
+                    self.target_tenths = 0
+                    self.flags &= ~SETPOINT_FIRE
+                    self.version += 1
+
+    def send_state(self, now):
+        flags = STATE_ENABLED
+        if self.flags & SETPOINT_FORWARD:
+            flags |= STATE_FORWARD | STATE_TARGET_FORWARD
+        if self.flags & SETPOINT_FIRE:
+            flags |= STATE_FIRING
+        for client in self.clients.values():
+            age = min(int((now - client["accepted"]) * 1000), 0xFFFF)
+            packet = STATE.pack(MAGIC, VERSION, TYPE_STATE, client["seq"], client["t"], age, 0,
+                                self.version, now_ms(), self.target_tenths, self.target_tenths, flags)
+            self.sock.sendto(packet, client["addr"])
+
+    def stop(self):
+        self.running = False
+        self.join()
+        self.sock.close()
+
+
+class Client:
+    def __init__(self, host, port, loss, client_id):
+        self.addr = (socket.gethostbyname(host), port)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(0.05)
+        self.loss = loss
+        self.client_id = client_id
+        self.seq = 0
+        self.sent = 0
+        self.lost_out = 0
+        self.lost_in = 0
+        self.states = 0
+        self.rtts = []
+        self.last_ack = None
+        self.last_state = None
+        self.running = True
+        self.receiver = threading.Thread(target=self.receive, daemon=True)
+        self.receiver.start()
+
+    def send(self, speed, forward=True, fire=False):
+        self.seq = (self.seq + 1) & 0xFFFFFFFF
+        flags = (SETPOINT_FORWARD if forward else 0) | (SETPOINT_FIRE if fire else 0)
+        tenths = max(0, min(1000, int(round(speed * 10))))
+        packet = SETPOINT.pack(MAGIC, VERSION, TYPE_SETPOINT, self.client_id, self.seq, now_ms(), tenths, flags, 0)
+        self.sent += 1
+        if random.random() < self.loss:
+            self.lost_out += 1
+            return
+        self.sock.sendto(packet, self.addr)
+
+    def receive(self):
+        while self.running:
+            try:
+                data, _ = self.sock.recvfrom(64)
+            except socket.timeout:
+                continue
+            except OSError:
+                return
+            if random.random() < self.loss:
+                self.lost_in += 1
+                continue
+            if len(data) != STATE.size:
+                continue
+            fields = STATE.unpack(data)
+            magic, version, kind, ack_seq, echo_ms, echo_age = fields[:6]
+            if magic != MAGIC or version != VERSION or kind != TYPE_STATE:
+                continue
+            self.states += 1
+            self.last_state = fields
+            # Only the first state that acknowledges a new setpoint measures its round trip
+            if self.last_ack is None or seq_newer(ack_seq, self.last_ack):
+                self.last_ack = ack_seq
+                self.rtts.append(((now_ms() - echo_ms) & 0xFFFFFFFF) - echo_age)
+
+    def close(self):
+        self.running = False
+        self.receiver.join()
+        self.sock.close()
+
+    def report(self):
+        print(f"setpoints sent: {self.sent} (dropped {self.lost_out} simulated)")
+        print(f"state datagrams: {self.states} (dropped {self.lost_in} simulated)")
+        if self.rtts:
+            rtts = sorted(self.rtts)
+            p95 = rtts[min(len(rtts) - 1, int(len(rtts) * 0.95))]
+            print(f"round trip ms: min {rtts[0]} avg {statistics.mean(rtts):.1f} "
+                  f"p50 {statistics.median(rtts)} p95 {p95} max {rtts[-1]} ({len(rtts)} samples)")
+        if self.last_state:
+            target = self.last_state[10] / 10.0
+            flags = self.last_state[11]
+            print(f"device target: {target:.1f}% {'forward' if flags & STATE_TARGET_FORWARD else 'reverse'}"
+                  f"{' FIRING' if flags & STATE_FIRING else ''}, ack seq {self.last_ack}")
+
+
+def speed_at(args, elapsed):
+    if args.sweep:
+        return 50.0 + 50.0 * math.sin(elapsed * 2 * math.pi / args.sweep)
+    return args.speed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", nargs="?", default="spacetornado.local")
+    parser.add_argument("--port", type=int, default=DEFAULT_PORT)
+    parser.add_argument("--rate", type=float, default=50.0, help="setpoints per second (>= 10 for the heartbeat)")
+    parser.add_argument("--duration", type=float, default=5.0, help="seconds to run")
+    parser.add_argument("--speed", type=float, default=0.0, help="fixed target speed (%%)")
+    parser.add_argument("--sweep", type=float, default=0.0, help="sweep 0-100%% with this period (s) instead")
+    parser.add_argument("--reverse", action="store_true")
+    parser.add_argument("--fire", action="store_true")
+    parser.add_argument("--loss", type=float, default=0.0, help="simulated loss per direction (0-1)")
+    parser.add_argument("--client-id", type=int, default=random.getrandbits(32))
+    parser.add_argument("--loopback", action="store_true", help="self-check against a Python model of the device")
+    args = parser.parse_args()
+
+    device = None
+    if args.loopback:
+        device = SimulatedDevice()
+        device.start()
+        args.host, args.port = "127.0.0.1", device.port
+        if not args.speed and not args.sweep:
+            args.sweep = 2.0
+
+    client = Client(args.host, args.port, args.loss, args.client_id)
+    interval = 1.0 / args.rate
+    start = time.monotonic()
+    next_send = start
+    speed = 0.0
+    while time.monotonic() - start < args.duration:
+        speed = speed_at(args, time.monotonic() - start)
+        client.send(speed, not args.reverse, args.fire)
+        next_send += interval
+        time.sleep(max(0.0, next_send - time.monotonic()))
+
+    # Keep repeating the final setpoint briefly so it survives the simulated loss
+    for _ in range(10):
+        client.send(speed, not args.reverse, args.fire)
+        time.sleep(interval)
+    time.sleep(0.1)
+    client.report()
+
+    ok = True
+    if device:
+        expected = int(round(speed * 10))
+        if device.target_tenths != expected:
+            print(f"FAIL: device target {device.target_tenths / 10:.1f}% != last setpoint {expected / 10:.1f}%")
+            ok = False
+        # Fall silent: the simulated device must stop within the timeout
+        time.sleep(CONTROL_TIMEOUT_S + 0.2)
+        if speed > 0 and (device.failsafes != 1 or device.target_tenths != 0):
+            print("FAIL: no failsafe stop after the client went silent")
+            ok = False
+        print(f"loopback: {device.stale} stale setpoints discarded, {device.failsafes} failsafe stop(s)")
+        print("client self-check: PASS" if ok else "client self-check: FAILED")
+        device.stop()
+
+    client.close()
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())